@@ -0,0 +1,24 @@
+
+#include "crc.h"
+
+
+/*
+ * Bitwise implementation: small code, no table.
+ *
+ * Only used rarely (e.g. checkpointing schedule), on a few dozen bytes,
+ * so speed of a table driven implementation is not needed.
+ */
+uint16_t crc16(const uint8_t* data, uint16_t count) {
+	uint16_t crc = 0xFFFF;
+
+	for (uint16_t i = 0; i < count; i++) {
+		crc ^= (uint16_t) (data[i] << 8);
+		for (uint8_t bit = 0; bit < 8; bit++) {
+			if (crc & 0x8000)
+				crc = (uint16_t) ((crc << 1) ^ 0x1021);
+			else
+				crc = (uint16_t) (crc << 1);
+		}
+	}
+	return crc;
+}
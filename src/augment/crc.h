@@ -0,0 +1,9 @@
+
+#pragma once
+
+#include <inttypes.h>
+
+// Not all platforms provide a CRC library (or a CRC peripheral reachable from SyncAgent.)
+
+// CRC-16-CCITT (polynomial 0x1021, initial value 0xFFFF) over count bytes.
+uint16_t crc16(const uint8_t* data, uint16_t count);
@@ -1,7 +1,6 @@
 
 #include <cassert>
 #include <inttypes.h>
-#include <cstdlib>	// rand() etc
 
 #include "random.h"	// Our random.h, not from libstdc++
 
@@ -9,43 +8,94 @@
 // FUTURE class and namespace to hide
 
 /*
- * Utility routines, assuming platform only provides rand()
+ * PCG32 (O'Neill): 64-bit LCG state, output permuted (xorshift high, random rotate) to 32 bits.
+ * inc selects one of 2^63 streams, must be odd.
  *
- * Notes:
- *
- * Std C rand() yields value in range [0, RAND_MAX],
- * Some sources say RAND_MAX >= 32767,
- * i.e. result fits in, but does not uniformly fill uint_16!!!
- * (!!! The shell command rand() yields random bytes i.e. uint8_t.)
- *
- * % is remainder operator.
- * With signed operands, % may yield negative result on some implementations.
- * Here we explicitly use unsigned operands.
+ * Range reduction (Lemire): multiply a 32-bit draw by range, take high word.
+ * Rejecting the few low words below (2^32 % range) makes it unbiased,
+ * unlike % which favors low values when range doesn't divide 2^32.
+ * Rejection is rare (probability range/2^32), so usually no division either.
  */
 
-uint16_t randUnsignedInt16(uint16_t min, uint16_t max) {
-	/*
-	 * Typical implementation with slight flaws in uniform distribution:
-	 * Unless max-min divides int without a remainder, binning means some bins receive more
-	 * values, i.e. non-uniform distribution.
-	 */
-	assert( max >= min);
-	assert((max - min) < RAND_MAX);	// else not uniformly distributed
-	int intResult = rand() % ( max + 1 - min) + min;
+namespace {
+
+const uint64_t Multiplier = 6364136223846793005ULL;
+
+// Default seed from reference implementation, until randSeed()
+uint64_t state = 0x853c49e6748fea9bULL;
+uint64_t inc = 0xda3e39cb94b95bdbULL;
+
+
+uint32_t next() {
+	uint64_t oldState = state;
+	state = oldState * Multiplier + inc;
+	uint32_t xorShifted = (uint32_t) (((oldState >> 18u) ^ oldState) >> 27u);
+	uint32_t rotation = (uint32_t) (oldState >> 59u);
+	return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31));
+}
+
+/*
+ * Uniform in [0, range), range not zero.
+ */
+uint32_t nextBelow(uint32_t range) {
+	assert(range > 0);
+	uint64_t product = (uint64_t) next() * range;
+	uint32_t low = (uint32_t) product;
+	if (low < range) {
+		uint32_t threshold = (0u - range) % range;	// 2^32 % range
+		while (low < threshold) {
+			product = (uint64_t) next() * range;
+			low = (uint32_t) product;
+		}
+	}
+	return (uint32_t) (product >> 32);
+}
+
+}	// namespace
 
-	// Convert, i.e. take lower two LSB
-	assert(intResult < UINT16_MAX);	// No loss of data
-	uint16_t result = (uint16_t) intResult;
+
+void randSeed(uint64_t seed, uint64_t stream) {
+	state = 0;
+	inc = (stream << 1u) | 1u;
+	(void) next();
+	state += seed;
+	(void) next();
+}
+
+
+void randSaveState(RandState* saved) {
+	saved->state = state;
+	saved->inc = inc;
+}
+
+void randRestoreState(const RandState* saved) {
+	assert((saved->inc & 1u) == 1u);
+	state = saved->state;
+	inc = saved->inc;
+}
+
+
+uint32_t randUnsignedInt32(uint32_t min, uint32_t max) {
+	assert( max >= min);
+	uint32_t result;
+	if (max - min == UINT32_MAX)
+		// Full range, range itself doesn't fit
+		result = next();
+	else
+		result = min + nextBelow(max - min + 1);
 	assert (result >= min && result <= max);	// ensure result as specified
 	return result;
 }
 
+uint16_t randUnsignedInt16(uint16_t min, uint16_t max) {
+	// No loss of data: result in [min, max]
+	return (uint16_t) randUnsignedInt32(min, max);
+}
+
 /*
  * Random flip of a fair coin.
- * Depends on rand()
+ * High bit: in PCG, all bits are good, but high bits are best.
  */
 bool randBool() {
-	unsigned int result = rand() % 2;
-	assert( result == 0 || result == 1);
-	return result;	// coerce to bool
+	return (next() >> 31) != 0;
 }
@@ -1,14 +1,33 @@
-
 #pragma once
 
 #include <inttypes.h>
 
-// Wrapper to platform provided std lib functions
+/*
+ * Pseudo random numbers, not from platform's rand().
+ *
+ * Std C rand() on most platforms (newlib) starts from the same default seed on every unit,
+ * so units reset together would make the same "random" choices (defeating collision avoidance.)
+ * This generator (PCG32) is seeded per unit.
+ * No allocation, a few instructions per draw.
+ */
+
+// Seed before any draw.  Stream distinct per unit (e.g. myID()), seed varies per reset (e.g. clock jitter.)
+void randSeed(uint64_t seed, uint64_t stream);
 
 // Get a random integer in the range [min, max] including both end points.
-// depends on stdlib rand()
+// Uniformly distributed (unbiased.)
 uint16_t randUnsignedInt16(uint16_t min, uint16_t max);
+uint32_t randUnsignedInt32(uint32_t min, uint32_t max);
 
 // Random flip of fair coin
-// depends on rand()
 bool randBool();
+
+/*
+ * State of generator, to resume a sequence exactly (e.g. replay from a recorded restart, see InputRecorder.)
+ */
+struct RandState {
+	uint64_t state;
+	uint64_t inc;
+};
+void randSaveState(RandState* saved);
+void randRestoreState(const RandState* saved);
@@ -1,6 +1,7 @@
 
 #include <cassert>
 #include "timeMath.h"
+#include "../syncAgent/modules/inputRecorder.h"
 
 
 /*
@@ -39,12 +40,12 @@ DeltaTime TimeMath::clampedTimeDifference(LongTime laterTime, LongTime earlierTi
  * Requires futureTime less than MaxDeltaTime from now
  */
 DeltaTime TimeMath::clampedTimeDifferenceFromNow(LongTime futureTime) {
-	DeltaTime result = clampedTimeDifference(futureTime, LongClockTimer::nowTime()); // Coerced to 32-bit with possible loss
+	DeltaTime result = clampedTimeDifference(futureTime, InputRecorder::nowTime()); // Coerced to 32-bit with possible loss
 	// Already asserted: assert(result < MaxDeltaTime);
 	return result;
 }
 DeltaTime TimeMath::clampedTimeDifferenceToNow(LongTime pastTime) {
-	DeltaTime result = clampedTimeDifference(LongClockTimer::nowTime(), pastTime); // Coerced to 32-bit with possible loss
+	DeltaTime result = clampedTimeDifference(InputRecorder::nowTime(), pastTime); // Coerced to 32-bit with possible loss
 	// Already asserted: assert(result < MaxDeltaTime);
 	return result;
 }
@@ -55,7 +56,7 @@ DeltaTime TimeMath::clampedTimeDifferenceToNow(LongTime pastTime) {
  * - givenTime is less than MAX_DELTA_TIME from now.
  */
 DeltaTime TimeMath::timeDifferenceFromNow(LongTime givenTime) {
-	LongTime now = LongClockTimer::nowTime();
+	LongTime now = InputRecorder::nowTime();
 	LongTime result;
 
 	// Subtract past time from larger future time, else modulo math gives a large result
@@ -124,3 +124,133 @@
  */
 #define LEAST_ID_IS_BETTER_CLIQUE 1
 
+
+/*
+ * Define if SyncAgent should xmit compact frames.
+ *
+ * Yes:
+ * masterID field carries a 24-bit clique tag hashed from master's ID (see CliqueTag.)
+ * Payload is 9 bytes instead of 12: less time on air, less energy, less exposure to collision.
+ * Platform's Radio::FixedPayloadCount must be 9.
+ * Rarely, two masters hash to the same tag; they detect it and one rehashes.
+ *
+ * No:
+ * masterID field carries full 48-bit ID of master.  Payload 12 bytes.
+ *
+ * Frames are distinguished by message type, so SyncAgent receives either (if radio delivers it.)
+ * But all units of a network should be configured the same,
+ * else units having full IDs and units having tags never agree on a clique.
+ */
+//#define SYNC_AGENT_COMPACT_OTA 1
+
+
+/*
+ * ID of network.  See NetworkID.
+ *
+ * Co-located networks sharing a channel should have distinct IDs, else they merge into each other.
+ * Zero: default network, platform's default radio address.  Compatible with units not configured.
+ * Non-zero: radio address derived from ID, and OTA type byte keyed by ID.
+ */
+#define SYNC_AGENT_NETWORK_ID 0
+
+
+/*
+ * Count of RF channels SyncAgent uses.  See ChannelPlan.
+ *
+ * One: every slot on platform's default channel (as before channel plans.)
+ * More: sync slot on a channel derived from clique, fishing interleaves channels.
+ * Co-located cliques contend less, but fishing takes proportionally longer to find another clique.
+ *
+ * Platform's Radio::configureChannel must support indexes up to this count less one.
+ * All units of a network should be configured the same:
+ * one, the default, is compatible with units built before channel plans.
+ */
+#define SYNC_AGENT_CHANNEL_COUNT 1
+
+
+/*
+ * Inverse of duty cycle: sync period is about this many times the awake slots.  See ScheduleParameters.
+ *
+ * Sync period in ticks is 80 times this (two 40 tick slots per unit of duty cycle.)
+ * 800: sync period 2 seconds.
+ * 12288: sync period 30 seconds (e.g. night mode.)
+ * 24576: sync period 60 seconds.
+ *
+ * Longer periods save power but clocks drift further between syncs,
+ * and dropout and fishing (counted in periods) take proportionally longer.
+ * Above 26214 (64 seconds) requires SYNC_AGENT_WIDE_OFFSET.
+ * At most 104857 (sync period 256 seconds, half the range of platform's 24-bit OSClock.)
+ *
+ * All units of a network should be configured the same.
+ * May be defined on the compiler command line instead (e.g. a host tool simulating a long period.)
+ */
+#ifndef SYNC_AGENT_DUTY_CYCLE_INVERSE
+#define SYNC_AGENT_DUTY_CYCLE_INVERSE 800
+#endif
+
+
+/*
+ * Define if SyncAgent should xmit offset in a 32-bit field.  See OTAPayload.
+ *
+ * Yes:
+ * Offset field 4 bytes.  Payload 13 bytes (10 compact.)
+ * Platform's Radio::FixedPayloadCount must be 13 (10 compact): see platformHeaders/radio.h.
+ *
+ * No:
+ * Offset field 3 bytes, of which 21 bits are offset: sync period at most 64 seconds.
+ *
+ * All units of a network should be configured the same.
+ */
+//#define SYNC_AGENT_WIDE_OFFSET 1
+
+
+/*
+ * Level of events recorded in binary trace.  See Trace and LogMessage.
+ *
+ * 0: none, trace compiles away.
+ * 1: slots, xmits, sync decisions, invalid receives, late schedule.
+ * 2: also every message received and details of schedule adjustment.
+ *
+ * Recording is cheap (no formatting), so even level 2 doesn't disturb timing much.
+ */
+#define SYNC_AGENT_TRACE_LEVEL 1
+
+
+/*
+ * Define if SyncAgent should relay sync across hops (broadcast mesh.)
+ *
+ * Yes:
+ * Sync carries hop count (distance from master.)
+ * A slave at hop h that heard sync from upstream (hop < h) in the sync slot
+ * relays it, in a later subslot of the sync slot.
+ * A slave only takes sync from upstream, so the shortest path wins and relays don't loop.
+ * Sync slot is longer by the relay subslots.
+ *
+ * No:
+ * Single-hop: every unit should hear the master.  Hop count always zero.
+ *
+ * All units of a network should be configured the same.
+ */
+//#define SYNC_AGENT_RELAY_MESH 1
+
+
+
+/*
+ * Define if SyncAgent should record its inputs from platform, for replay off-target.  See InputRecorder.
+ *
+ * Yes:
+ * Every input (clock readings, wake reasons, received packets, CRC status, RSSI, ...) and every traced decision
+ * is recorded in a ring of 1024 records, from SyncAgent::init and never stopping.
+ * Recording restarts every sync period (at SyncCheckpoint::periodicSave) with the state to resume from.
+ * tools/replay feeds the recording to the same build on a workstation and checks it decides the same.
+ * A replay reaches only as far back as the ring: from init until the ring wraps,
+ * after that from the oldest restart still in the ring, i.e. the last few sync periods
+ * (at least the current period; fewer the busier the unit, about a dozen records per period go to the restart.)
+ * Costs RAM (8 bytes per record, see InputRecording) and a few stores per input.
+ *
+ * No:
+ * Inputs are read from platform directly, recorder compiles away.
+ *
+ * Replay requires the same source and configuration as the recorded build.
+ */
+//#define SYNC_AGENT_RECORD_INPUTS 1
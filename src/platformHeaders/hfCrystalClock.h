@@ -0,0 +1,27 @@
+
+#pragma once
+
+/*
+ * High frequency crystal oscillator (HFXO) needed by radio.
+ *
+ * Starting takes a while (e.g. 360 uSec on nRF52, about 12 ticks of OSClock)
+ * and the duration varies with temperature and crystal.
+ */
+class HfCrystalClock {
+public:
+	/*
+	 * Start and return immediately (not wait for crystal to stabilize.)
+	 * Lets SyncAgent overlap the start with sleep.
+	 */
+	static void start();
+
+	/*
+	 * Start (if not already started by start()) and sleep until stable.
+	 */
+	static void startAndSleepUntilRunning();
+
+	// Crystal is stable: radio can be enabled.
+	static bool isRunning();
+
+	static void stop();
+};
@@ -44,6 +44,7 @@
 #include <cstdlib>
 
 #include "../platformHeaders/radio.h"
+#include "../platformHeaders/hfCrystalClock.h"
 #include "../platformHeaders/sleeper.h"
 #include "../platformHeaders/osClock.h"
 #include "../platformHeaders/uniqueID.h"
@@ -53,6 +54,7 @@
 #include "../platformHeaders/mailbox.h"
 #include "../platformHeaders/logger.h"
 #include "../platformHeaders/types.h"
+#include "../platformHeaders/retainedMemory.h"
 
 
 
@@ -69,6 +71,7 @@
 #ifdef OLD
 // Arrange project CFLAGS += -I/home/bootch/git/nRF5rawProtocol/modules
 #include <radio.h>
+#include <hfCrystalClock.h>
 
 // -I/home/bootch/git/nRF5rawProtocol/platform
 #include <sleeper.h>
@@ -78,6 +81,7 @@
 #include <mailbox.h>
 #include <powerManager.h>
 #include <ledLogger.h>
+#include <retainedMemory.h>
 #endif
 
 
@@ -2,6 +2,9 @@
 
 #include <inttypes.h>
 
+#include "hfCrystalClock.h"
+#include "../config.h"	// SYNC_AGENT_COMPACT_OTA, SYNC_AGENT_WIDE_OFFSET
+
 /*
  * Wrapper aka abstraction layer for software stack for radio/wireless
  */
@@ -11,14 +14,46 @@ class Radio {
 public:
 	/*
 	 * Length of payload buffer owned by device.
+	 * Must equal length of SyncAgent's OTA payload (see OTAPayload), which depends on config.h.
 	 */
-
-	static const uint8_t FixedPayloadCount = 11;
+#if defined(SYNC_AGENT_COMPACT_OTA) && defined(SYNC_AGENT_WIDE_OFFSET)
+	static const uint8_t FixedPayloadCount = 10;
+#elif defined(SYNC_AGENT_COMPACT_OTA)
+	static const uint8_t FixedPayloadCount = 9;
+#elif defined(SYNC_AGENT_WIDE_OFFSET)
+	static const uint8_t FixedPayloadCount = 13;
+#else
+	static const uint8_t FixedPayloadCount = 12;
+#endif
 	// FUTURE, when messages are DYNAMIC (variable-length) static const uint8_t MaxMsgLength = 255;
 
+	// Clock that radio requires, owned by radio but started and stopped by SyncAgent
+	HfCrystalClock* hfCrystalClock;
+
 	static void init(void (*onRcvMsgCallback)());
 	static void powerOnAndConfigure();
-	static void configureXmitPower(unsigned int dBm);
+	/*
+	 * dBm is signed (e.g. -20 .. +4 on nRF52.)
+	 * Platform rounds to a level it supports.
+	 * Call after powerOnAndConfigure().
+	 */
+	static void configureXmitPower(int8_t dBm);
+
+	/*
+	 * Configure address that radio xmits and matches on receive.
+	 * Radio (in hardware if possible) rejects packets with other address, without interrupt.
+	 * Platform may ignore if it can't filter by address (SyncAgent filters in software too.)
+	 * Call after powerOnAndConfigure().
+	 */
+	static void configureNetworkAddress(uint32_t base, uint8_t prefix);
+
+	/*
+	 * Configure RF channel that radio xmits and receives on.
+	 * Channel is an index (see ChannelPlan), platform maps it to a frequency (e.g. nRF52 FREQUENCY register.)
+	 * Index zero is platform's default channel.
+	 * Radio must be powered on and DISABLED (not xmitting or receiving.)
+	 */
+	static void configureChannel(uint8_t channel);
 	static void powerOff();
 	static bool isPowerOn();
 
@@ -102,6 +137,21 @@ public:
 	// FUTURE we could use isReadyToReceive() to assert (instead of !isDisabled() )
 
 	static bool isPacketCRCValid();
+
+	/*
+	 * Received signal strength of last received packet, in dBm (negative, e.g. -60.)
+	 * Platform samples it during receive (e.g. nRF52 RSSI sampled on ADDRESS event.)
+	 * Valid after a packet received, until next receive.
+	 */
+	static int8_t receivedSignalStrength();
+
+	/*
+	 * Clear channel assessment (energy or carrier detect.)
+	 * Radio must be powered on and not xmitting or receiving (DISABLED state.)
+	 * Blocks for the assessment (e.g. 128 uSec on nRF52, about 4 ticks) and leaves radio DISABLED.
+	 * Platform without CCA returns true.
+	 */
+	static bool isChannelClear();
 };
 
 
@@ -0,0 +1,33 @@
+
+#pragma once
+
+#include <inttypes.h>
+
+/*
+ * Memory that survives an mcu reset, e.g. the brownout at dusk of a solar powered unit.
+ *
+ * Platform may implement as:
+ * - RAM retained through System OFF or a soft reset (e.g. a .noinit section)
+ * - a flash page (write() erases and programs the page)
+ *
+ * SyncAgent does not trust the content: it validates with its own CRC.
+ * After a power on reset (region never written, or RAM lost power) content is arbitrary.
+ *
+ * Platform also knows how long the unit was down,
+ * if it has a clock that keeps counting while the mcu is reset or off
+ * (e.g. RTC on a supercap-backed domain, or an external calendar chip.)
+ */
+class RetainedMemory {
+public:
+	// Count of bytes in region.  Zero if platform has no retained memory.
+	static uint16_t size();
+
+	static void read(uint8_t* dest, uint16_t count);
+	static void write(const uint8_t* src, uint16_t count);
+
+	/*
+	 * Ticks (at OSClock frequency) elapsed since last write(), counted across reset.
+	 * Returns false if platform can't know, e.g. its clock also lost power.
+	 */
+	static bool ticksSinceWrite(uint64_t* ticks);
+};
@@ -43,6 +43,18 @@ public:
 	static void sleepUntilEventWithTimeout(OSTime);
 	static void cancelTimeout();
 
+	/*
+	 * Deadline semantics, alternative to sleepUntilEventWithTimeout.
+	 *
+	 * setDeadline() programs timer once (e.g. RTC compare register) for an absolute time of LongClock.
+	 * A deadline in the past (or too near to program) expires immediately.
+	 * sleepUntilEvent() sleeps without touching the timer:
+	 * after a wake for another reason the deadline remains armed.
+	 * cancelTimeout() cancels a deadline.
+	 */
+	static void setDeadline(uint64_t deadline);	// LongTime
+	static void sleepUntilEvent();
+
 	static ReasonForWake getReasonForWake();
 	static void clearReasonForWake();
 
@@ -40,3 +40,14 @@ void SleepSyncAgent::loopOnEvents() {
 	syncAgent.loop();	// Never returns
 }
 
+
+const DeadlineMonitor::Stats& SleepSyncAgent::phaseTiming(DeadlineMonitor::Phase phase) {
+	return DeadlineMonitor::stats(phase);
+}
+
+DeltaTime SleepSyncAgent::phasePercentile(DeadlineMonitor::Phase phase, uint8_t percent) {
+	return DeadlineMonitor::percentile(phase, percent);
+}
+
+void SleepSyncAgent::resetPhaseTiming() { DeadlineMonitor::reset(); }
+
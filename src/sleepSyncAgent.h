@@ -1,5 +1,6 @@
 
 #include "syncAgent/syncAgent.h"
+#include "syncAgent/modules/deadlineMonitor.h"
 #include <nRF5x.h>	// Radio, Mailbox, LongClockTimer
 
 
@@ -21,8 +22,8 @@
  * (That is a design decision, onSyncPoint could be called far from the SyncSlot.)
  *
  * Generally, onSyncPoint() should be kept short.
- * Typically, onSyncPoint() should return within 3mSec (say within 100k instructions?)
- * else it will cut into the SyncSlot and affect Syncing.
+ * Time it takes cuts into self's SyncSlot (self may miss syncs that period)
+ * but does not shift self's schedule: SyncPoints are kept regardless of processing delays.
  *
  * Since it is not the time when Sync messages are exchanged,
  * onSyncPoint() CAN do a small amount of 'work.'
@@ -51,7 +52,11 @@
  *
  * 5. This wraps (simplifies) the public API of SyncAgent.
  *
- * 5. Parameters of algorithm.
+ * 6. Timing.  App can read how long phases take against their deadlines (see DeadlineMonitor),
+ * including its own onSyncPoint(): overruns there are overruns of the app.
+ * Read from onSyncPoint() (or when not syncing): the table is not locked.
+ *
+ * 7. Parameters of algorithm.
  *
  * The parameters are by default rather loose.
  * For example, a msg takes 3 ticks but a slot is 300 ticks,
@@ -79,4 +84,8 @@ public:
 			void (*onSyncPoint)()
 			);
 	static void loopOnEvents() __attribute__ ((noreturn));
+
+	static const DeadlineMonitor::Stats& phaseTiming(DeadlineMonitor::Phase phase);
+	static DeltaTime phasePercentile(DeadlineMonitor::Phase phase, uint8_t percent);
+	static void resetPhaseTiming();
 };
@@ -7,6 +7,10 @@ SyncSleeper syncSleeper;
 Clique clique;
 SyncAgent syncAgent;
 Serializer serializer;
+SyncCheckpoint syncCheckpoint;
+RadioPrewarm radioPrewarm;
+XmitPowerPolicy xmitPowerPolicy;
+LinkQualityTable linkQualityTable;
 
 //SimpleFishPolicy fishPolicy;
 SyncRecoveryFishPolicy fishPolicy;
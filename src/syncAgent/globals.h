@@ -22,6 +22,15 @@ class Clique;
 //#include "modules/clique.h"
 extern Clique clique;
 
+/*
+ * xmitPowerPolicy used by syncBehaviour, network, and slots
+ */
+#include "policy/xmitPowerPolicy.h"
+extern XmitPowerPolicy xmitPowerPolicy;
+
+#include "modules/linkQuality.h"
+extern LinkQualityTable linkQualityTable;
+
 #include "modules/role.h"
 extern MergerFisherRole role;
 
@@ -31,14 +40,23 @@ extern Serializer serializer;
 #include "modules/syncSleeper.h"
 extern SyncSleeper syncSleeper;
 
+/*
+ * network used by syncSender
+ */
+#include "modules/network.h"
+extern Network network;
+
 #include "modules/syncSender.h"
 extern SyncSender syncSender;
 
 #include "modules/syncBehaviour.h"
 extern SyncBehaviour syncBehaviour;
 
-#include "modules/network.h"
-extern Network network;
+#include "modules/syncCheckpoint.h"
+extern SyncCheckpoint syncCheckpoint;
+
+#include "modules/radioPrewarm.h"
+extern RadioPrewarm radioPrewarm;
 /*
  * fishPolicy used by clique and fishSchedule
  */
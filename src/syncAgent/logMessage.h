@@ -1,38 +1,129 @@
 #pragma once
 
+#include <inttypes.h>
+
+#include "../config.h"	// SYNC_AGENT_TRACE_LEVEL
+#include "modules/trace.h"
+
 /*
  * Holds log messages.
+ *
+ * Events of hot path (while radio is listening) are not formatted strings:
+ * each is an ID recorded in binary by trace() (see Trace), decoded off-target.
+ *
+ * Level is top two bits of ID (see SYNC_AGENT_TRACE_LEVEL.)
+ * Zero ID means an empty record.
+ * IDs are recorded in trace: append, don't renumber (decoder uses nameOf().)
  */
 class LogMessage {
 public:
-	// logged at start of slots
-	static constexpr const char* SyncSlot = "SyncSlot\n";
-	static constexpr const char* WorkSlot = "WorkSlot\n";
-	static constexpr const char* FishSlot = "FishSlot\n";
-	static constexpr const char* MergeSlot = "MergeSlot\n";
-
-	// logged in dispatch messages received
-	static constexpr const char* RXMasterSync = "  RX Master\n";
-	static constexpr const char* RXWorseMasterSync = "  RX WorseMaster\n";
-	static constexpr const char* RXMergeSync = "  RX Merge\n";
-	static constexpr const char* RXAbandonMastership = "  RX AbandonMastership\n";
-	static constexpr const char* RXWorkSync = "  RX Work\n";
-	static constexpr const char* RXUnknown = "  RX unknown msg type\n";
-
-	static constexpr const char* FishedMasterSync = "Fish Master\n";
-	static constexpr const char* FishedMergeSync = "Fish Merge\n";
-	static constexpr const char* FishedWorkSync = "Fish Work\n";
-
-	// Sending
-	static constexpr const char* SendMasterSync = "TX Master\n";
-	static constexpr const char* SendWorkSync = "TX Work\n";
-	static constexpr const char* SendMergeSync = "TX Merge\n";
-	static constexpr const char* SendWork = "TX Work\n";
-	static constexpr const char* SendNone = "Listen\n";
-
-	static void logStartSyncPeriod(LongTime now) {
-		return;
-		logLongLong(now);
-		log("<Sync\n");
+	static const uint8_t LevelShift = 6;
+
+	enum Event : uint8_t {
+		// Level 1: slots, xmits, sync decisions, errors
+
+		// traced at start of slots
+		SyncSlot = 0x40,
+		WorkSlot,
+		FishSlot,
+		MergeSlot,
+		StartSyncPeriod,	// arg: LSB of now
+
+		FishedMasterSync,
+		FishedMergeSync,
+		FishedWorkSync,
+
+		// Sending
+		SendMasterSync,
+		SendWorkSync,
+		SendMergeSync,
+		SendRelaySync,
+
+		// Received but invalid
+		Garbled,
+		BadCRC,
+
+		// Schedule
+		PeriodsMissed,	// arg: count
+		LateSyncPoint,	// arg: lateness
+		Shortened,	// arg: ticks period shortened by adjustment
+		DeadlineOverrun,	// arg: DeadlineMonitor::Phase in MSB, lateness in 24 LSB
+
+		FishedUnreliable,	// arg: LSB of MasterID
+
+		// Level 2: every message received, details of adjustment
+
+		// traced in dispatch messages received
+		RXMasterSync = 0x80,
+		RXMergeSync,
+		RXAbandonMastership,
+		RXWorkSync,
+		RXUnknown,	// arg: type
+
+		// SyncBehaviour::doSyncMsg, arg: LSB of MasterID
+		SyncFromDownstream,
+		SyncFromMyClique,
+		SyncFromBetterUnreliable,
+		SyncFromBetter,
+		SyncFromWorseWhileMaster,
+		SyncFromWorseWhileSlave,
+
+		AdjustTOA,	// arg: LSB of toa
+		AdjustOffset,	// arg: offset
+		AdjustPeriodEnd	// arg: LSB of new end
+	};
+
+	static constexpr uint8_t levelOf(Event event) { return (uint8_t) (event >> LevelShift); }
+
+	/*
+	 * For decoding off-target.  Not referenced on target, linker drops it.
+	 */
+	static const char* nameOf(uint8_t event) {
+		switch(event) {
+		case SyncSlot: return "SyncSlot";
+		case WorkSlot: return "WorkSlot";
+		case FishSlot: return "FishSlot";
+		case MergeSlot: return "MergeSlot";
+		case StartSyncPeriod: return "StartSyncPeriod";
+		case FishedMasterSync: return "Fish Master";
+		case FishedMergeSync: return "Fish Merge";
+		case FishedWorkSync: return "Fish Work";
+		case SendMasterSync: return "TX Master";
+		case SendWorkSync: return "TX Work";
+		case SendMergeSync: return "TX Merge";
+		case SendRelaySync: return "TX Relay";
+		case Garbled: return ">>>>Message garbled";
+		case BadCRC: return ">>>>CRC";
+		case PeriodsMissed: return "periods missed";
+		case LateSyncPoint: return "late SyncPoint";
+		case Shortened: return "shortened";
+		case DeadlineOverrun: return "deadline overrun";
+		case FishedUnreliable: return "Fish unreliable link, ignored";
+		case RXMasterSync: return "  RX Master";
+		case RXMergeSync: return "  RX Merge";
+		case RXAbandonMastership: return "  RX AbandonMastership";
+		case RXWorkSync: return "  RX Work";
+		case RXUnknown: return "  RX unknown msg type";
+		case SyncFromDownstream: return "Sync from downstream";
+		case SyncFromMyClique: return "Sync from my clique";
+		case SyncFromBetterUnreliable: return "Better master, unreliable link";
+		case SyncFromBetter: return "Better master";
+		case SyncFromWorseWhileMaster: return "Worse sync while self is master";
+		case SyncFromWorseWhileSlave: return "Worse sync while self is slave";
+		case AdjustTOA: return "toa";
+		case AdjustOffset: return "offset";
+		case AdjustPeriodEnd: return "new period end";
+		default: return "?";
+		}
 	}
 };
+
+
+/*
+ * Record event in trace, if its level is configured.
+ * Level is a constant: a disabled trace compiles to nothing.
+ */
+inline void trace(LogMessage::Event event, uint32_t arg = 0) {
+	if (LogMessage::levelOf(event) <= SYNC_AGENT_TRACE_LEVEL)
+		Trace::record(event, arg);
+}
@@ -0,0 +1,45 @@
+
+#include <cassert>
+#include "channelPlan.h"
+#include "../scheduleParameters.h"
+
+
+namespace {
+
+/*
+ * Count of fish slots per pass.
+ * Every FishPolicy visits every sleeping slot in this many consecutive fish slots (after a reset.)
+ */
+const SlotCount CountFishSlotsPerPass = ScheduleParameters::CountSlots - ScheduleParameters::FirstSleepingSlotOrdinal + 1;
+
+uint8_t firstChannel = 0;
+uint8_t channel = 0;
+// Fish slots since reset
+uint32_t countFishSlots = 0;
+
+} // namespace
+
+
+uint8_t ChannelPlan::fishChannel() { return channel; }
+
+
+/*
+ * Channel is (index of sleeping slot + index of pass), from firstChannel.
+ * The same slot in successive passes is on successive channels.
+ * Adjacent slots are on different channels, and a FishPolicy jumps among slots,
+ * so successive fish slots are (mostly) on different channels.
+ */
+void ChannelPlan::advanceFishing(SlotCount ordinal) {
+	assert(ordinal >= ScheduleParameters::FirstSleepingSlotOrdinal);
+	SlotCount indexOfSlot = ordinal - ScheduleParameters::FirstSleepingSlotOrdinal;
+	uint32_t indexOfPass = countFishSlots / CountFishSlotsPerPass;
+	channel = (uint8_t) ((firstChannel + indexOfSlot + indexOfPass) % CountChannels);
+	countFishSlots++;
+}
+
+
+void ChannelPlan::resetFishing(uint8_t aChannel) {
+	firstChannel = aChannel;
+	channel = aChannel;
+	countFishSlots = 0;
+}
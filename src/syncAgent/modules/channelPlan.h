@@ -0,0 +1,55 @@
+#pragma once
+
+#include <inttypes.h>
+#include "../../config.h"	// SYNC_AGENT_CHANNEL_COUNT
+#include "../types.h"	// ScheduleCount
+#include "../../platformHeaders/types.h"	// SystemID
+
+
+/*
+ * Knows which RF channel each slot uses.
+ *
+ * Channel is an index in [0, CountChannels), the platform maps it to a frequency.
+ * Index zero is platform's default channel.
+ *
+ * Sync slot: on clique's channel (see Clique::channel().)
+ * A new clique's channel is derived from its MasterID.
+ * Co-located cliques (likely) use different channels, and don't contend in each other's sync slots.
+ * The channel is clique state, carried in every sync (see OTAPayload):
+ * when master drops out, former slaves keep the channel and find each other there;
+ * when a clique merges into another, its members adopt the channel of the other.
+ *
+ * Fish slot: interleaves channels, on a channel derived from the fished slot's ordinal and the pass.
+ * A pass is the count of fish slots in which a FishPolicy visits every sleeping slot.
+ * Each pass moves every slot one channel further than the previous pass,
+ * so a slot is fished on a different channel in each of CountChannels passes,
+ * whatever order the FishPolicy visits slots in.
+ * Thus in CountChannels passes, every (slot, channel) pair is fished:
+ * any other clique whose sync slot is not drifting rapidly is caught (rendezvous guaranteed.)
+ * Meanwhile every channel is fished often, at scattered slots:
+ * a nearby clique is usually caught within the first pass, not after CountChannels passes.
+ * (Holding one channel for a whole pass left cliques on other channels unmerged for passes,
+ * while they in turn fished channels where no one was.)
+ * After fishing is reset (e.g. master dropout) the first fish slot is on given channel.
+ *
+ * Merge slot: on the channel of the mergee clique's sync slot (see CliqueMerger.)
+ *
+ * Cost: fishing takes CountChannels times longer to find another clique.
+ * Benefit: dense deployments scale with CountChannels.
+ */
+class ChannelPlan {
+public:
+	static const uint8_t CountChannels = SYNC_AGENT_CHANNEL_COUNT;
+
+	// Channel of a clique newly created by given master
+	static uint8_t newCliqueChannel(SystemID masterID) { return (uint8_t) (masterID % CountChannels); }
+
+	// Channel for current fish slot
+	static uint8_t fishChannel();
+
+	// Called once per fish slot, before fishing, with ordinal of slot to fish.
+	static void advanceFishing(SlotCount ordinal);
+
+	// Restart fishing on given channel
+	static void resetFishing(uint8_t channel);
+};
@@ -4,6 +4,9 @@
 #include "clique.h"
 
 #include "../globals.h"  // fishPolicy
+#include "cliqueTag.h"
+#include "channelPlan.h"
+#include "otaPacket.h"	// MaxHopCount
 #include "../policy/dropoutMonitor.h"
 //#include "../policy/masterXmitSyncPolicy.h"
 #include "../policy/adaptiveXmitSyncPolicy.h"
@@ -12,6 +15,8 @@ namespace {
 
 // attributes of clique
 SystemID masterID;
+uint8_t _hopCount = 0;
+uint8_t _channel = 0;
 
 // collaborators
 DropoutMonitor dropoutMonitor;
@@ -34,6 +39,7 @@ void Clique::init(){
 	log("Clique init\n");
 
 	setSelfMastership();
+	_channel = ChannelPlan::newCliqueChannel(masterID);
 	dropoutMonitor.reset();
 	masterXmitSyncPolicy.reset();
 	schedule.startFreshAfterHWReset();
@@ -44,13 +50,41 @@ void Clique::init(){
 }
 
 
+/*
+ * Called only after a hw reset, when SyncCheckpoint has a valid, recent checkpoint.
+ *
+ * If remembered master was another unit, self is a slave of it:
+ * self listens in the sync slot but does not xmit sync.
+ * Master may also have browned out and not returned.
+ * Then dropoutMonitor expires and self assumes mastership, as if master dropped out while running.
+ */
+void Clique::initFromCheckpoint(SystemID rememberedMasterID, uint8_t rememberedChannel){
+	log("Clique init from checkpoint\n");
+
+	if (rememberedMasterID == CliqueTag::selfMasterID())
+		setSelfMastership();
+	else {
+		setOtherMastership(rememberedMasterID);
+		// Path to master unknown: accept sync from any hop
+		_hopCount = OTAPayload::MaxHopCount;
+	}
+	_channel = rememberedChannel;
+	dropoutMonitor.reset();
+	masterXmitSyncPolicy.reset();
+	// Clique was joined before reset, xmit sync at the retarded frequency.
+	if (!isSelfMaster())
+		masterXmitSyncPolicy.advanceStage();
+}
+
+
 
 
 SystemID Clique::getMasterID() { return masterID; }
 
 void Clique::setSelfMastership() {
 	log("set self mastership\n");
-	masterID = myID();
+	masterID = CliqueTag::selfMasterID();
+	_hopCount = 0;
 }
 
 /*
@@ -67,7 +101,7 @@ void Clique::setOtherMastership(SystemID otherID) {
 	masterID = otherID;
 }
 
-bool Clique::isSelfMaster() { return masterID == myID(); }
+bool Clique::isSelfMaster() { return masterID == CliqueTag::selfMasterID(); }
 
 
 /*
@@ -91,6 +125,25 @@ bool Clique::shouldXmitSync() {
  */
 bool Clique::isMsgFromMyClique(SystemID otherMasterID){ return masterID == otherMasterID; }
 
+
+uint8_t Clique::hopCount() { return _hopCount; }
+
+uint8_t Clique::channel() { return _channel; }
+
+/*
+ * Single hop: every sync from my clique is from upstream (hop counts all zero, self not master.)
+ * Mesh: a sync from my clique at the same or greater hop count was relayed from self's own sync (or a peer's.)
+ * Taking it would feed self's schedule back into itself.
+ */
+bool Clique::isMsgFromUpstream(SyncMessage* msg) {
+#ifdef SYNC_AGENT_RELAY_MESH
+	return msg->hopCount < _hopCount;
+#else
+	(void) msg;
+	return true;
+#endif
+}
+
 /*
  * All units use same comparison.  The direction is arbitrary.
  * For testing, it may help to swap it.
@@ -133,6 +186,8 @@ void Clique::checkMasterDroppedOut() {
 		log("    MASTER DROP OUT\n");
 		onMasterDropout();
 	}
+	else if (dropoutMonitor.isSyncOverdue())
+		linkQualityTable.missedSync(masterID);
 }
 
 void Clique::onMasterDropout() {
@@ -143,8 +198,13 @@ void Clique::onMasterDropout() {
 	 */
 	// FUTURE: history of masters, self assume mastership only if was most recent master, thus avoiding contention.
 
+	SystemID formerMasterID = masterID;
+	// Succession: not follow former master again until its link proves reliable (see LinkQualityTable)
+	linkQualityTable.droppedOut(formerMasterID);
 	setSelfMastership();	// !!! changes role: self will start xmitting sync
 	masterXmitSyncPolicy.reset();
+	// Lost members: they might be hearing self but not hearing master.  Reach them.
+	xmitPowerPolicy.reset();
 
 	/*
 	 * !!! Schedule is NOT changed. We may be able to recover by fishing nearby.
@@ -157,11 +217,18 @@ void Clique::onMasterDropout() {
 	 * - drifted too much
 	 */
 	fishPolicy.reset();
+	// Drifted master is on clique's channel, which self inherited (as did other former slaves.)
+	ChannelPlan::resetFishing(_channel);
 }
 
 
 
 
+void Clique::onMergeActivity() {
+	masterXmitSyncPolicy.onMergeActivity();
+}
+
+
 /*
  * An update, not necessarily a change.  Not assert result data different from current data.
  * The MasterID may be the same as current.
@@ -175,8 +242,15 @@ void Clique::updateBySyncMessage(SyncMessage* msg) {
 	 * !!! Update.  Not assert that msg.MasterID != self.masterID:
 	 * a WorkSync from a Slave carries MasterID of clique which could match my MasterID when self is Master
 	 */
+	bool isMasterChanged = (masterID != msg->masterID);
 	setOtherMastership(msg->masterID);
+	// Same channel if from my clique, else join other clique on its channel
+	_channel = msg->channel;
 	// Not assert master changed
+#ifdef SYNC_AGENT_RELAY_MESH
+	// Shortest path so far (or a new clique.)  Saturates: far hops join but don't relay.
+	_hopCount = (msg->hopCount < OTAPayload::MaxHopCount) ? msg->hopCount + 1 : OTAPayload::MaxHopCount;
+#endif
 
 	/*
 	 * Self has heard another unit, retard policy.
@@ -187,6 +261,13 @@ void Clique::updateBySyncMessage(SyncMessage* msg) {
 	 */
 	masterXmitSyncPolicy.advanceStage();
 
+	/*
+	 * Inform policy of activity in clique.
+	 * Only relevant if self is (or later becomes) Master.
+	 */
+	if (isMasterChanged || msg->type == MergeSync)
+		onMergeActivity();
+
 	// FUTURE clique.historyOfMasters.update(msg);
 
 	// Change schedule.
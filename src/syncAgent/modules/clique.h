@@ -25,13 +25,19 @@ public:
 	// Newly created Clique instance
 	static void init();
 
+	/*
+	 * Alternative to init(): clique remembered across a reset (see SyncCheckpoint.)
+	 * Schedule is resumed separately.
+	 */
+	static void initFromCheckpoint(SystemID rememberedMasterID, uint8_t rememberedChannel);
+
 
 
 	/*
 	 * Methods related to mastership and ID of clique.
 	 */
 	static SystemID getMasterID();
-	// This unit (with ID given by myID() ) is master of clique
+	// This unit (with ID given by CliqueTag::selfMasterID(), usually myID() ) is master of clique
 	static void setSelfMastership();
 	static void setOtherMastership(SystemID otherMasterID);
 	static bool isSelfMaster();
@@ -40,6 +46,21 @@ public:
 	static bool isOtherCliqueBetter(SystemID otherMasterID);
 	static bool isMsgFromMyClique(SystemID otherMasterID);
 
+	/*
+	 * Distance of self from master (SYNC_AGENT_RELAY_MESH.)  Zero when self is master.
+	 * Sync from my clique keeps my sync only if from upstream (less hops.)
+	 */
+	static uint8_t hopCount();
+	static bool isMsgFromUpstream(SyncMessage* msg);
+
+	/*
+	 * Channel of clique's sync slot (see ChannelPlan.)
+	 * Chosen when clique is created, carried in every sync.
+	 * Not changed by a change of master within clique (dropout, tag collision): members keep listening there.
+	 * Adopted from the sync of another clique that self joins.
+	 */
+	static uint8_t channel();
+
 
 
 	/*
@@ -50,6 +71,12 @@ public:
 	// Clique is losing member that was Master
 	static void onMasterDropout();
 
+	/*
+	 * Clique membership or schedule is changing (self fished another clique, or was merged.)
+	 * Master xmits sync more often until clique is stable again.
+	 */
+	static void onMergeActivity();
+
 	/*
 	 * Update clique from heard SyncMessage:
 	 * - master <= SyncMessage
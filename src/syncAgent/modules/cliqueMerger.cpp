@@ -19,6 +19,10 @@ Clique* owningClique;
 
 MergeOffset offsetToMergee;
 SystemID masterID;
+uint8_t mergeeChannel;
+
+// Next SyncPoint of Catch clique, from offset in fished msg
+LongTime _nextSyncPointOfCatch;
 
 
 /*
@@ -46,18 +50,24 @@ LongTime nextSyncPointOfFisher() {
 	return result;
 }
 /*
- * Assert now we just received a SyncMsg from middle of SyncSlot of Catch clique
+ * Catch's SyncPoint is computed from the offset in fished SyncMsg, not from when it arrived.
+ * Formerly assumed msg was xmitted at middle of Catch's SyncSlot,
+ * but a relayed sync (SYNC_AGENT_RELAY_MESH) is xmitted later in the slot.
+ * The offset was calculated by sender as it sent, so it is correct wherever in the slot it was sent.
  */
+void memoizeNextSyncPointOfCatch(SyncMessage* msg) {
+	_nextSyncPointOfCatch = messageTimeOfArrival() + msg->deltaToNextSyncPoint.get();
+}
+
 // Time in future when Catch will be in middle of next SyncSlot
 LongTime middleOfNextSyncSlotOfCatch() {
-	LongTime result = messageTimeOfArrival() + ScheduleParameters::NormalSyncPeriodDuration;
+	LongTime result = _nextSyncPointOfCatch + ScheduleParameters::DeltaToSyncSlotMiddle;
 	return result;
 }
 // Time in past when Catch started SyncSlot
 LongTime pastSyncPointOfCatch() {
-	LongTime result = messageTimeOfArrival() - ScheduleParameters::DeltaToSyncSlotMiddle;
+	LongTime result = _nextSyncPointOfCatch - ScheduleParameters::NormalSyncPeriodDuration;
 	// TODO minus a halfMessageLatency or other adjustment???
-	// WAS: owningClique->schedule.halfSlotDuration();
 	return result;
 }
 
@@ -129,6 +139,8 @@ void initMergeMyClique(SyncMessage* msg){
 
 	// Using unadjusted schedule
 	offsetToMergee.set(offsetForMergeMyClique());
+	// Mergee is my former clique, on its channel
+	mergeeChannel = owningClique->channel();
 
 	// FUTURE migrate this outside and return result to indicate it should be done
 	// After using current clique above, change my clique (new master and new schedule)
@@ -140,7 +152,7 @@ void initMergeMyClique(SyncMessage* msg){
 }
 
 
-void initMergeOtherClique(){
+void initMergeOtherClique(SyncMessage* msg){
 	/*
 	 * Start sending sync to other clique members telling them to merge to self's clique,
 	 * and pass them offset from now to next SyncPoint
@@ -152,12 +164,14 @@ void initMergeOtherClique(){
 	 *   |S..|W..|..........M........|S |
 	 *   mergeSlot is not aligned with slots in schedule.
 	 *
-	 * We don't care which SyncMessage we fished or which MasterID owned the other clique.
+	 * We don't care which MasterID owned the other clique.
 	 */
 	log("Merge other clique\n");
 
 	// WRONG setOffsetToMergee(owningClique->schedule.deltaNowToNextSyncPoint());
 	offsetToMergee.set(offsetForMergeOtherClique());
+	// Mergee is the catch, on its channel (self fished on it)
+	mergeeChannel = msg->channel;
 
 	// No adjustment to self schedule
 
@@ -181,10 +195,12 @@ void CliqueMerger::initFromMsg(SyncMessage* msg){
 	log("Other Master ID: \n");
 	logLongLong(msg->masterID);
 
+	memoizeNextSyncPointOfCatch(msg);
+
 	if (owningClique->isOtherCliqueBetter(msg->masterID))
 		initMergeMyClique(msg);
 	else
-		initMergeOtherClique();
+		initMergeOtherClique(msg);
 
 	isActive = true;
 	assert(isActive);
@@ -197,37 +213,25 @@ void CliqueMerger::initFromMsg(SyncMessage* msg){
 void CliqueMerger::adjustMergerBySyncMsg(SyncMessage* msg) {
 	/*
 	 * This unit's role isMerger (cliqueMerger.isActive)
-	 * Heard a sync message in syncSlot that adjusts this units schedule.
+	 * Heard a sync message in syncSlot that adjusted this units schedule (later or sooner.)
 	 * Make similar adjustment to this CliqueMerger, so that any MergeSync sent is at the correct time.
 	 *
 	 * My sync slot is moving, merge time must move to stay at same wall time (to hit the sync slot of mergee.)
+	 * Merge time is relative to end of period (see Schedule::timeOfThisMergeStart):
+	 * it stays at same wall time if offset moves opposite to the correction, modulo period.
+	 * If the period was shortened past the merge time, MergeSlot skips this period's merge.
 	 */
 	// assert current slot is Sync
 	// assert msg is MasterSync (small offset) or MergeSync (large offset)
-	// assert endOfSyncPeriod was changed, it now is my new end of sync period
-
-	(void) msg;	// temporarily suppress warnings
-	log("Not implemented: adjustMerger\n");
-	// TODO implement adjustMerger
-	/*
-	 * FUTURE, when more than two units.
-	 * When only two units, it doesn't matter if MergeSync is off, since there is no third unit to hear it.
-	 * Unless it interferes with other slot?
-	 */
+	(void) msg;	// Correction already applied to schedule
 	assert(isActive);
 
-#ifdef FUTURE
-	// The new next sync point is not at the old one before this msg adjusted endSyncPoint.
-
-	DeltaTime deltaStartSyncPeriodToNewNextSyncPoint = owningClique->schedule.halfSlotDuration() + msg->deltaToNextSyncPoint;
-	(void) deltaStartSyncPeriodToNewNextSyncPoint;
-	// For now, do nothing, and xmit MergeSyncs at wrong time
-
-	// offsetToMergee -= msg->deltaToNextSyncPoint;
-	// FUTURE this is not right, result could be negative.  Need modulo.
-	// Also, if the mergeSlot now overlaps sync or work slot?
-#endif
-	return;
+	const int64_t period = ScheduleParameters::NormalSyncPeriodDuration;
+	int64_t adjusted = ((int64_t) offsetToMergee.get() - owningClique->schedule.lastCorrection()) % period;
+	if (adjusted < 0)
+		adjusted += period;
+	offsetToMergee.set((DeltaTime) adjusted);
+	// FUTURE if the merge time now overlaps sync slot?
 }
 
 
@@ -255,3 +259,5 @@ void CliqueMerger::makeMergeSync(SyncMessage& msg){
 const MergeOffset* const CliqueMerger::getOffsetToMergee() {
 	return &offsetToMergee;
 }
+
+uint8_t CliqueMerger::getMergeeChannel() { return mergeeChannel; }
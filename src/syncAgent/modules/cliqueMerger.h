@@ -37,4 +37,7 @@ public:
 	static void makeMergeSync(SyncMessage& msg);
 
 	static const MergeOffset* const getOffsetToMergee();
+
+	// Channel of mergee clique's sync slot, where self xmits MergeSync
+	static uint8_t getMergeeChannel();
 };
@@ -0,0 +1,54 @@
+
+#include "cliqueTag.h"
+#include "../../config.h"
+#include "../../augment/random.h"
+
+
+
+#ifdef SYNC_AGENT_COMPACT_OTA
+
+namespace {
+
+// Changed on collision.  Not retained across reset: a reset unit rehashes from salt zero.
+uint8_t salt = 0;
+
+/*
+ * FNV-1a over the bytes of the ID and the salt, xor-folded to 24 bits.
+ */
+SystemID hashToTag(SystemID id, uint8_t aSalt) {
+	uint32_t hash = 2166136261u;
+	for (unsigned int i = 0; i < sizeof(id); i++) {
+		hash ^= (uint8_t) (id >> (8*i));
+		hash *= 16777619u;
+	}
+	hash ^= aSalt;
+	hash *= 16777619u;
+	return (hash >> 24) ^ (hash & 0xFFFFFF);
+}
+
+} // namespace
+
+
+SystemID CliqueTag::selfMasterID() {
+	// FUTURE memoize, rehashing every call is cheap but frequent
+	return hashToTag(myID(), salt);
+}
+
+bool CliqueTag::onCollision() {
+	log("Clique tag collision\n");
+	if (randBool()) {
+		salt++;
+		return true;
+	}
+	else
+		return false;
+}
+
+#else
+
+SystemID CliqueTag::selfMasterID() { return myID(); }
+
+// Full IDs are unique, collision can't happen.
+bool CliqueTag::onCollision() { return false; }
+
+#endif
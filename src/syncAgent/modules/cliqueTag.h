@@ -0,0 +1,32 @@
+
+#pragma once
+
+#include <nRF5x.h>	// SystemID
+
+
+/*
+ * Knows the ID that self puts in the masterID field when self is master.
+ *
+ * Full frame: the unit's own 48-bit ID, myID().  Unique.
+ *
+ * Compact frame (SYNC_AGENT_COMPACT_OTA): a 24-bit tag hashed from myID().
+ * The only operations on masterID are equality and ordering (see Clique),
+ * so a tag serves as well, except that two units may (rarely) hash to the same tag.
+ * Every unit uses tags everywhere (Clique, CliqueMerger), never a mix of tags and full IDs.
+ *
+ * Collision: a master hears a MasterSync carrying its own tag.
+ * Only a master xmits MasterSync, and self can't hear itself, so another master has the same tag.
+ * Both may detect it; each flips a coin and on heads rehashes its tag with a new salt.
+ *
+ * Singleton: all members static.
+ */
+class CliqueTag {
+public:
+	static SystemID selfMasterID();
+
+	/*
+	 * Heard MasterSync with own tag from another master.
+	 * Returns true if self changed its tag (and so the masterID of its clique.)
+	 */
+	static bool onCollision();
+};
@@ -0,0 +1,112 @@
+
+#include <cassert>
+
+#include "deadlineMonitor.h"
+#include "../logMessage.h"
+#include "inputRecorder.h"
+
+
+namespace {
+
+DeadlineMonitor::Stats table[DeadlineMonitor::CountPhases];
+LongTime entryTime[DeadlineMonitor::CountPhases];
+
+
+uint8_t bucketOf(DeltaTime duration) {
+	uint8_t bucket = 0;
+	while (duration > 0 && bucket < DeadlineMonitor::CountBuckets - 1) {
+		duration >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+DeltaTime upperBoundOf(uint8_t bucket) {
+	return (bucket == 0) ? 0 : (DeltaTime) ((1u << bucket) - 1);
+}
+
+} // namespace
+
+
+void DeadlineMonitor::reset() {
+	for (uint8_t phase = 0; phase < CountPhases; phase++) {
+		Stats& stats = table[phase];
+		stats.count = 0;
+		stats.countOverruns = 0;
+		stats.countSkips = 0;
+		stats.maxDuration = 0;
+		stats.maxLateness = 0;
+		for (uint8_t bucket = 0; bucket < CountBuckets; bucket++)
+			stats.histogram[bucket] = 0;
+	}
+}
+
+
+void DeadlineMonitor::enter(Phase phase) {
+	assert(phase < CountPhases);
+	entryTime[phase] = InputRecorder::nowTime();
+}
+
+
+void DeadlineMonitor::exit(Phase phase, LongTime deadline) {
+	assert(phase < CountPhases);
+	LongTime now = InputRecorder::nowTime();
+	Stats& stats = table[phase];
+
+	// Clamp: a phase of a whole period is still small
+	LongTime longDuration = now - entryTime[phase];
+	DeltaTime duration = (longDuration > UINT32_MAX) ? UINT32_MAX : (DeltaTime) longDuration;
+
+	stats.count++;
+	if (duration > stats.maxDuration)
+		stats.maxDuration = duration;
+	uint16_t& bucketCount = stats.histogram[bucketOf(duration)];
+	if (bucketCount < UINT16_MAX)
+		bucketCount++;
+
+	if (now > deadline) {
+		DeltaTime lateness = (now - deadline > UINT32_MAX) ? UINT32_MAX : (DeltaTime) (now - deadline);
+		if (lateness > stats.maxLateness)
+			stats.maxLateness = lateness;
+		if (lateness > Tolerance) {
+			stats.countOverruns++;
+			// arg: phase in MSB, lateness in 24 LSB
+			trace(LogMessage::DeadlineOverrun, ((uint32_t) phase << 24) | (lateness & 0xFFFFFF));
+		}
+	}
+}
+
+
+void DeadlineMonitor::skip(Phase phase) {
+	assert(phase < CountPhases);
+	table[phase].countSkips++;
+}
+
+
+const DeadlineMonitor::Stats& DeadlineMonitor::stats(Phase phase) {
+	assert(phase < CountPhases);
+	return table[phase];
+}
+
+
+DeltaTime DeadlineMonitor::percentile(Phase phase, uint8_t percent) {
+	assert(phase < CountPhases);
+	assert(percent <= 100);
+	const Stats& stats = table[phase];
+
+	// Histogram saturates: sum it rather than use count
+	uint32_t total = 0;
+	for (uint8_t bucket = 0; bucket < CountBuckets; bucket++)
+		total += stats.histogram[bucket];
+	if (total == 0)
+		return 0;
+
+	uint32_t wanted = (total * percent + 99) / 100;	// rounded up
+	uint32_t cumulative = 0;
+	for (uint8_t bucket = 0; bucket < CountBuckets; bucket++) {
+		cumulative += stats.histogram[bucket];
+		if (cumulative >= wanted)
+			return (bucket == CountBuckets - 1) ? stats.maxDuration : upperBoundOf(bucket);
+	}
+	return stats.maxDuration;
+}
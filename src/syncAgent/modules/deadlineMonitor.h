@@ -0,0 +1,72 @@
+#pragma once
+
+#include <inttypes.h>
+#include <nRF5x.h>	// LongTime
+#include "../types.h"	// DeltaTime
+
+
+/*
+ * Measures phases of a sync period against their deadlines.
+ *
+ * A phase that overruns its deadline silently costs sync:
+ * e.g. a slow onSyncPoint callback eats the sync slot, a fish slot spills past the SyncPoint.
+ * Each phase is timestamped at entry and exit; exit is compared to the phase's deadline.
+ *
+ * A slot's phase starts at slot start, after the sleep to it: the sleep is not the slot's duration.
+ * A slot skipped because its time already passed (the schedule moved) is counted as skipped, not executed.
+ *
+ * Per phase (fixed table, no heap):
+ * - count of executions, of overruns (exit later than deadline plus Tolerance), and of skips
+ * - max duration and max lateness
+ * - histogram of durations, in power of two buckets, for percentiles
+ *
+ * Overruns are also traced (LogMessage::DeadlineOverrun.)
+ * App reads the table through SleepSyncAgent.
+ *
+ * Cost per phase: two clock reads and a few adds.
+ *
+ * Singleton: all members static.
+ */
+class DeadlineMonitor {
+public:
+	enum Phase : uint8_t {
+		SyncPointCallbackPhase,	// App's onSyncPoint, deadline: middle of sync slot
+		SyncWorkSlotPhase,	// deadline: end of sync slot
+		FishSlotPhase,	// deadline: end of fish slot
+		MergeSlotPhase,	// deadline: end of merge xmit
+		SlotSequencePhase,	// All slots of period, deadline: next SyncPoint
+		CountPhases
+	};
+
+	/*
+	 * Exit a few ticks past deadline is normal: a sleep ends at deadline, then slot cleans up.
+	 */
+	static const DeltaTime Tolerance = 2;
+
+	// Bucket i counts durations in [2^(i-1), 2^i) ticks, bucket 0 counts zero.  Last bucket also counts longer.
+	static const uint8_t CountBuckets = 16;
+
+	struct Stats {
+		uint32_t count;
+		uint32_t countOverruns;
+		uint32_t countSkips;
+		DeltaTime maxDuration;
+		DeltaTime maxLateness;
+		uint16_t histogram[CountBuckets];	// saturating
+	};
+
+	static void reset();
+
+	static void enter(Phase phase);
+	static void exit(Phase phase, LongTime deadline);
+	// Instead of enter and exit
+	static void skip(Phase phase);
+
+	static const Stats& stats(Phase phase);
+
+	/*
+	 * Duration (ticks) not exceeded by given percent of executions of phase.
+	 * Upper bound of histogram bucket, i.e. within a factor of two.
+	 */
+	static DeltaTime percentile(Phase phase, uint8_t percent);
+};
@@ -27,6 +27,10 @@
  * for OSClock resolution==1/32khz and SlotDuration==300 ticks:
  * - 2-bytes, 16-bits, MaxDeltaSync is 64k:  max DutyCyleInverse is 30
  * - 3-bytes, 24-bits, MaxDeltaSync is 16M: max DutyCycleInverse is 10k
+ * for OSClock resolution==1/32khz and SlotDuration==40 ticks (current):
+ * - 3-bytes, of which 21 bits offset (3 bits hop count): max DutyCycleInverse is 26k, sync period 64 seconds
+ * - 4-bytes (SYNC_AGENT_WIDE_OFFSET): limited instead by TimeMath on 24-bit OSClock, sync period 256 seconds
+ * Sleeps are not limited by the platform Timer: SyncSleeper chains them.
  * for OSClock resolution==1/32khz and SlotDuration==50 ticks:
  * - 2-bytes, 16-bits, MaxDeltaSync is 64k:  max DutyCyleInverse is 180
  *
@@ -0,0 +1,120 @@
+
+#include "inputRecorder.h"
+
+#ifdef SYNC_AGENT_RECORD_INPUTS
+
+#include "../globals.h"	// radio
+
+static_assert(sizeof(InputRecord) == 8, "Input record layout must match replay.");
+// Index by mask, and countRecorded wraps without a jump in index
+static_assert((InputRecording::CountRecords & (InputRecording::CountRecords - 1)) == 0,
+		"Count of input records must be power of two.");
+
+
+InputRecording inputRecording = { InputRecording::Magic, 0, 0, {} };
+
+
+namespace {
+
+LongTime lastClock = 0;
+
+InputRecord* nextRecord(InputRecorder::Kind kind) {
+	// Ring: overwrites oldest
+	InputRecord* record = &inputRecording.records[inputRecording.countRecorded++ & (InputRecording::CountRecords - 1)];
+	record->kind = kind;
+	record->data[0] = 0;
+	record->data[1] = 0;
+	record->data[2] = 0;
+	record->value = 0;
+	return record;
+}
+
+void put(InputRecorder::Kind kind, uint8_t flag, uint64_t wideValue = 0) {
+	InputRecord* record = nextRecord(kind);
+	record->data[0] = flag;
+	record->data[1] = (uint8_t) (wideValue >> 32);
+	record->data[2] = (uint8_t) (wideValue >> 40);
+	record->value = (uint32_t) wideValue;
+}
+
+void putBytes(InputRecorder::Kind kind, const volatile uint8_t* bytes, uint16_t count) {
+	for (uint16_t first = 0; first < count; first += InputRecord::CountBytes) {
+		InputRecord* record = nextRecord(kind);
+		for (uint8_t index = 0; index < InputRecord::CountBytes && first + index < count; index++) {
+			if (index < 3)
+				record->data[index] = bytes[first + index];
+			else
+				record->value |= (uint32_t) bytes[first + index] << (8 * (index - 3));
+		}
+	}
+}
+
+} // namespace
+
+
+void InputRecorder::start() {
+	inputRecording.magic = InputRecording::Magic;
+	inputRecording.countRecorded = 0;
+	SystemID id = myID();
+	inputRecording.id = id;
+	put(Identity, 0, (uint32_t) id);
+	put(Identity, 1, (uint32_t) (id >> 32));
+}
+
+
+LongTime InputRecorder::clock(LongTime time) {
+	put(Clock, 0, time);
+	lastClock = time;
+	return time;
+}
+
+LongTime InputRecorder::timestamp() { return lastClock; }
+
+ReasonForWake InputRecorder::wake(ReasonForWake reason) {
+	put(Wake, (uint8_t) reason);
+	// Packet is input too: serializer reads it from radio buffer
+	if (reason == MsgReceived)
+		putBytes(Payload, radio->getBufferAddress(), Radio::FixedPayloadCount);
+	return reason;
+}
+
+bool InputRecorder::flag(Kind kind, bool value) {
+	put(kind, value);
+	return value;
+}
+
+int8_t InputRecorder::signalStrength(int8_t dBm) {
+	put(SignalStrength, (uint8_t) dBm);
+	return dBm;
+}
+
+WorkPayload InputRecorder::work(WorkPayload payload) {
+	put(WorkFetched, 0, payload);
+	return payload;
+}
+
+uint16_t InputRecorder::retainedSize(uint16_t size) {
+	put(RetainedSize, 0, size);
+	return size;
+}
+
+void InputRecorder::retainedBytes(const uint8_t* data, uint16_t count) {
+	putBytes(RetainedBytes, data, count);
+}
+
+bool InputRecorder::retainedAge(bool result, uint64_t ticks) {
+	put(RetainedAge, result, ticks);
+	return result;
+}
+
+
+void InputRecorder::decision(uint8_t event, uint32_t arg) {
+	put(Decision, event, arg);
+}
+
+void InputRecorder::restart(const uint8_t* state, uint16_t count) {
+	put(Restart, 0, count);
+	putBytes(RestartState, state, count);
+}
+
+#endif
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <inttypes.h>
+#include <nRF5x.h>	// LongTime, ReasonForWake, WorkPayload
+
+#include "../../config.h"	// SYNC_AGENT_RECORD_INPUTS
+
+
+/*
+ * Recording of SyncAgent's inputs from platform, for deterministic replay off-target.
+ *
+ * SyncAgent is deterministic given its inputs: clock readings, reasons for wake, received packets,
+ * CRC status, RSSI, clear channel, power, HFXO running, mail from app, retained memory.
+ * Each input is read from platform through a tap: InputRecorder::clock(longClock->nowTime()) etc.
+ * A tap records the value read and returns it.
+ * Traced events (trace(), at SYNC_AGENT_TRACE_LEVEL) are also recorded, as decisions to check a replay against.
+ *
+ * tools/replay is a platform that serves the recorded inputs, in order, to the same build of SyncAgent,
+ * and compares what it records to the recording: same decisions, or the index where it diverged.
+ *
+ * Recording starts at SyncAgent::init (InputRecorder::start) and never stops: the buffer is a ring,
+ * holding the latest CountRecords records.
+ * Since a ring loses init, recording restarts every sync period (SyncCheckpoint::periodicSave):
+ * a Restart record, then the checkpoint and the rest of the state a replay resumes from (RestartState bytes.)
+ * Replay starts at init if the ring has not wrapped, else at the oldest restart in the ring.
+ * Costs about a dozen records per sync period.
+ *
+ * Read off-target like trace: debugger dumps inputRecording (gdb "dump binary value inputs.bin inputRecording".)
+ * Layout is fixed width little-endian, no padding.
+ *
+ * Not configured (SYNC_AGENT_RECORD_INPUTS): taps are inline identities, no buffer.
+ */
+
+struct InputRecord {
+	uint8_t kind;	// InputRecorder::Kind
+	uint8_t data[3];	// data[0]: flag or small value.  data[1..2]: bits 32..47 of a wide value
+	uint32_t value;
+
+	// Bytes (packet, retained memory) are packed seven per record: data, then value LSB first
+	static const uint8_t CountBytes = 7;
+
+	uint64_t wideValue() const {
+		return ((uint64_t) data[2] << 40) | ((uint64_t) data[1] << 32) | value;
+	}
+	uint8_t byteAt(uint8_t index) const {
+		return (index < 3) ? data[index] : (uint8_t) (value >> (8 * (index - 3)));
+	}
+};
+
+struct InputRecording {
+	static const uint32_t Magic = 0x52504C5A;	// "RPLZ": ring layout (was "RPLY")
+	static const uint16_t CountRecords = 1024;
+
+	uint32_t magic;
+	uint32_t countRecorded;	// Since init.  Monotonic, next record at countRecorded % CountRecords
+	uint64_t id;	// myID(): Identity records are overwritten when ring wraps
+	InputRecord records[CountRecords];
+};
+
+
+class InputRecorder {
+public:
+	/*
+	 * Kinds are in recordings: append, don't renumber.
+	 */
+	enum Kind : uint8_t {
+		Empty,
+		Identity,	// Two records, myID() LSB then MSB.  First in recording.
+		Clock,	// LongClock, wide
+		Wake,	// data[0]: ReasonForWake.  When MsgReceived, followed by Payload records
+		Payload,	// Radio buffer bytes, Radio::FixedPayloadCount of them
+		CRCValid,	// data[0]: bool
+		SignalStrength,	// data[0]: int8_t dBm
+		ChannelClear,	// data[0]: bool
+		PowerForRadio,	// data[0]: bool
+		CrystalRunning,	// data[0]: bool
+		Mail,	// data[0]: bool
+		WorkFetched,	// value: WorkPayload
+		RetainedSize,	// value
+		RetainedBytes,	// Bytes, count as read
+		RetainedAge,	// data[0]: bool result, ticks wide
+		Decision,	// data[0]: LogMessage::Event, value: arg
+		Restart,	// value: count of bytes following in RestartState records
+		RestartState	// Bytes, see SyncCheckpoint::periodicSave
+	};
+
+#ifdef SYNC_AGENT_RECORD_INPUTS
+	static void start();
+
+	static LongTime clock(LongTime);
+	static ReasonForWake wake(ReasonForWake);
+	static bool flag(Kind kind, bool);
+	static int8_t signalStrength(int8_t);
+	static WorkPayload work(WorkPayload);
+	static uint16_t retainedSize(uint16_t);
+	static void retainedBytes(const uint8_t* data, uint16_t count);
+	static bool retainedAge(bool, uint64_t ticks);
+
+	static void decision(uint8_t event, uint32_t arg);
+
+	// State to replay from, first in a restarted recording
+	static void restart(const uint8_t* state, uint16_t count);
+#else
+	static void start() {}
+
+	static LongTime clock(LongTime time) { return time; }
+	static ReasonForWake wake(ReasonForWake reason) { return reason; }
+	static bool flag(Kind, bool value) { return value; }
+	static int8_t signalStrength(int8_t dBm) { return dBm; }
+	static WorkPayload work(WorkPayload payload) { return payload; }
+	static uint16_t retainedSize(uint16_t size) { return size; }
+	static void retainedBytes(const uint8_t*, uint16_t) {}
+	static bool retainedAge(bool result, uint64_t) { return result; }
+
+	static void decision(uint8_t, uint32_t) {}
+#endif
+
+	static LongTime nowTime() { return clock(LongClockTimer::nowTime()); }
+
+	/*
+	 * Time for a trace timestamp: not an input, never recorded, so tracing doesn't change a recording.
+	 * Recording: the last clock reading recorded (replay has no other clock.)  Else: a raw read.
+	 */
+#ifdef SYNC_AGENT_RECORD_INPUTS
+	static LongTime timestamp();
+#else
+	static LongTime timestamp() { return LongClockTimer::nowTime(); }
+#endif
+};
+
+#ifdef SYNC_AGENT_RECORD_INPUTS
+// Not in anonymous namespace: debugger and replay find it by name
+extern InputRecording inputRecording;
+#endif
@@ -0,0 +1,126 @@
+
+#include <nRF5x.h>  // logger
+
+#include "linkQuality.h"
+#include "../policy/policyParameters.h"
+
+
+namespace {
+
+/*
+ * Success rate in [0, RateScale].
+ * Moves 1/8 of the way toward 0 or RateScale per packet.
+ * New entry starts above threshold: first packet was a success.
+ */
+const uint8_t RateScale = 255;
+const uint8_t InitialRate = 192;
+// After dropout: about four packets heard to be reliable again
+const uint8_t DroppedOutRate = 96;
+
+struct Entry {
+	SystemID masterID;
+	uint8_t rate;
+	int8_t rssi;
+	// Times self deferred following this clique, saturating
+	uint8_t deferrals;
+	// Value of packetClock when last heard, for replacement
+	uint16_t lastHeard;
+	bool isUsed;
+};
+
+Entry table[LinkQualityTable::CountEntries];
+
+// Counts packets, wraps.  Only differences matter.
+uint16_t packetClock = 0;
+
+
+Entry* find(SystemID masterID) {
+	for (uint8_t i = 0; i < LinkQualityTable::CountEntries; i++) {
+		if (table[i].isUsed && table[i].masterID == masterID)
+			return &table[i];
+	}
+	return nullptr;
+}
+
+// Unused entry, else least recently heard
+Entry* victim() {
+	Entry* result = &table[0];
+	for (uint8_t i = 0; i < LinkQualityTable::CountEntries; i++) {
+		if (!table[i].isUsed)
+			return &table[i];
+		if ((uint16_t)(packetClock - table[i].lastHeard) > (uint16_t)(packetClock - result->lastHeard))
+			result = &table[i];
+	}
+	return result;
+}
+
+void succeed(Entry* entry) { entry->rate += (RateScale - entry->rate) / 8; }
+
+void fail(Entry* entry) { entry->rate -= (entry->rate + 7) / 8; }
+
+} // namespace
+
+
+
+
+void LinkQualityTable::reset() {
+	for (uint8_t i = 0; i < CountEntries; i++)
+		table[i].isUsed = false;
+}
+
+
+void LinkQualityTable::heard(SystemID masterID, int8_t rssi) {
+	packetClock++;
+
+	Entry* entry = find(masterID);
+	if (entry == nullptr) {
+		entry = victim();
+		entry->masterID = masterID;
+		entry->rate = InitialRate;
+		entry->rssi = rssi;
+		entry->deferrals = 0;
+		entry->isUsed = true;
+	}
+	else {
+		succeed(entry);
+		// EWMA weight 1/4.  Arithmetic in int16 to avoid overflow.
+		entry->rssi = (int8_t) (entry->rssi + ((int16_t) rssi - entry->rssi) / 4);
+	}
+	entry->lastHeard = packetClock;
+}
+
+
+void LinkQualityTable::missedSync(SystemID masterID) {
+	Entry* entry = find(masterID);
+	if (entry != nullptr)
+		fail(entry);
+	// else master not heard recently, nothing to charge
+}
+
+
+void LinkQualityTable::droppedOut(SystemID masterID) {
+	Entry* entry = find(masterID);
+	if (entry != nullptr) {
+		if (entry->rate > DroppedOutRate)
+			entry->rate = DroppedOutRate;
+		// Defer rejoining anew
+		entry->deferrals = 0;
+	}
+}
+
+
+bool LinkQualityTable::shouldDefer(SystemID masterID) {
+	Entry* entry = find(masterID);
+	if (entry == nullptr)
+		return false;
+
+	if (entry->rate >= Policy::MinReliableLinkRate
+			&& entry->rssi >= Policy::MinReliableLinkRSSI)
+		return false;
+
+	// Unreliable.  Still heard after many deferrals: no better link turned up.
+	if (entry->deferrals >= Policy::MaxDeferralsPerLink)
+		return false;
+	entry->deferrals++;
+	return true;
+}
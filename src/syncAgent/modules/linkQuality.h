@@ -0,0 +1,53 @@
+#pragma once
+
+#include <inttypes.h>
+#include "../../platformHeaders/types.h"	// SystemID
+
+
+/*
+ * Table of recently heard senders and quality of link from them.
+ *
+ * Sender is identified by MasterID (a frame does not identify the unit that sent it, only its clique.)
+ * So an entry is the link to a clique, mostly to its master.
+ *
+ * Per entry:
+ * - success rate, exponentially weighted: up per valid packet, down per missed expected sync
+ * - received signal strength, exponentially weighted
+ *
+ * A garbled packet (bad CRC or type) can't say who sent it (maybe a foreign clique's collision): not counted.
+ * A missed expected sync can: a slave expects its master's sync at least once per max span between MasterSyncs
+ * (see DropoutMonitor::isSyncOverdue.)
+ *
+ * Used:
+ * - in sync slot and fish slot, to defer following or merging a clique over an unreliable link,
+ *   in hope a better link to it turns up (e.g. via a member of that clique, or a relay.)
+ *   Only deferred: after Policy::MaxDeferralsPerLink, the weak link is the only one, use it.
+ *   (Else a weak RSSI, which nothing improves, would partition the units for good.)
+ * - on dropout: the former master's link is unreliable until heard again for a while.
+ *   Self succeeds it (assumes mastership), and doesn't flap back on the first sync heard from it.
+ *
+ * Fixed size, no heap.  When full, least recently heard entry is replaced.
+ * Each update scans the table: bounded by CountEntries, i.e. constant per message.
+ */
+class LinkQualityTable {
+public:
+	static const uint8_t CountEntries = 8;
+
+	static void reset();
+
+	// Valid packet from clique of given MasterID
+	static void heard(SystemID masterID, int8_t rssi);
+
+	// Sync expected from clique of given MasterID, not heard
+	static void missedSync(SystemID masterID);
+
+	// Self dropped out of clique of given MasterID
+	static void droppedOut(SystemID masterID);
+
+	/*
+	 * Should self defer following (or merging) clique, because link from it is unreliable?
+	 * False when not in table (no evidence against it.)
+	 * Counts deferrals: false once deferred too often, until next dropout from it.
+	 */
+	static bool shouldDefer(SystemID masterID);
+};
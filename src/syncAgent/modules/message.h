@@ -55,6 +55,9 @@ public:
 	DeltaSync deltaToNextSyncPoint;	// forward in time
 	SystemID masterID;
 	WorkPayload work;	// work always present, not always defined
+	uint8_t hopCount;	// Distance of sender from master.  Zero unless SYNC_AGENT_RELAY_MESH
+	uint8_t channel;	// Sync channel of clique identified by masterID (see ChannelPlan.)  Zero when one channel
+	int8_t xmitPower;	// dBm sender xmitted at (see XmitPowerPolicy)
 
 	// OLD constructor SyncMessage() :type(MasterSync), deltaToNextSyncPoint(0), masterID(0), work(0) {}
 
@@ -63,6 +66,9 @@ public:
 		deltaToNextSyncPoint.set(aDeltaToNextSyncPoint);	// throws assertion if out of range
 		masterID = aMasterID;
 		work = 0;
+		hopCount = 0;
+		channel = 0;
+		xmitPower = 0;
 	}
 
 
@@ -3,6 +3,22 @@
 
 #include "../globals.h"
 #include "network.h"
+#include "networkID.h"
+
+
+namespace {
+
+uint8_t channel = 0;
+// Radio forgets configuration when powered off
+bool isChannelConfigured = false;
+bool isXmitPowerConfigured = false;
+// Last configured
+int8_t configuredXmitPowerDBm = 0;
+
+// Until shutdown
+bool isFullXmitPower = false;
+
+} // namespace
 
 
 void Network::preamble() {
@@ -13,17 +29,39 @@ void Network::postlude() {
 	radio->hfCrystalClock->stop();
 }
 
+void Network::setChannel(uint8_t aChannel) {
+	if (aChannel != channel) {
+		channel = aChannel;
+		isChannelConfigured = false;
+	}
+}
+
+
 /*
  * If radio not already powered on, make it so.
+ * If channel changed, configure it.
  */
 void Network::prepareToTransmitOrReceive() {
 	if (!radio->isPowerOn()) {
 			radio->powerOnAndConfigure();
-			// TESTING: lower xmit power 8
-			// radio->configureXmitPower(8);
+			// Default network keeps platform's default address
+			if (!NetworkID::isDefault())
+				radio->configureNetworkAddress(NetworkID::addressBase(), NetworkID::addressPrefix());
+			isChannelConfigured = false;
+			isXmitPowerConfigured = false;
 		}
 	assert(radio->isPowerOn());
 	assert(radio->isDisabledState());	// not is receiving
+	if (!isXmitPowerConfigured) {
+		// Power chosen by policy takes effect when radio next powered on
+		configuredXmitPowerDBm = isFullXmitPower ? XmitPowerPolicy::fullPowerDBm() : xmitPowerPolicy.dBm();
+		radio->configureXmitPower(configuredXmitPowerDBm);
+		isXmitPowerConfigured = true;
+	}
+	if (!isChannelConfigured) {
+		radio->configureChannel(channel);
+		isChannelConfigured = true;
+	}
 }
 
 void Network::startReceiving() {
@@ -41,7 +79,19 @@ void Network::stopReceiving() {
 	assert(radio->isDisabledState());	// not is receiving
 }
 
+void Network::setFullXmitPower() {
+	if (!isFullXmitPower) {
+		isFullXmitPower = true;
+		isXmitPowerConfigured = false;
+	}
+}
+
+int8_t Network::xmitPowerDBm() {
+	return configuredXmitPowerDBm;
+}
+
 void Network::shutdown() {
+	isFullXmitPower = false;
 	radio->powerOff();
 	assert(!radio->isPowerOn());
 }
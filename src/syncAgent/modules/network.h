@@ -11,7 +11,24 @@ public:
 	// Preamble mainly starts HfCrystalClock needed by radio
 	static void preamble();
 
+	/*
+	 * Channel for subsequent xmit and receive.
+	 * Takes effect at next prepareToTransmitOrReceive (radio must not be receiving then.)
+	 */
+	static void setChannel(uint8_t channel);
+
+	/*
+	 * Full xmit power, not the policy's, until shutdown.
+	 * For xmits to another clique (MergeSync): policy tunes power to self's clique.
+	 * Takes effect at next prepareToTransmitOrReceive.
+	 */
+	static void setFullXmitPower();
+
 	static void prepareToTransmitOrReceive();
+
+	// Xmit power radio was last configured with (by prepareToTransmitOrReceive)
+	static int8_t xmitPowerDBm();
+
 	static void startReceiving();
 	static void stopReceiving();
 	static void shutdown();
@@ -0,0 +1,57 @@
+
+#pragma once
+
+#include <inttypes.h>
+#include "../../config.h"	// SYNC_AGENT_NETWORK_ID
+
+
+/*
+ * Knows how a network ID (see config.h) separates co-located networks sharing a channel.
+ *
+ * Two mechanisms:
+ *
+ * 1. Radio address.
+ * Network ID maps to the radio's address (base and prefix), configured through Radio.
+ * Radio peripheral rejects foreign traffic by address match, without waking mcu.
+ *
+ * 2. Software fallback, for platforms without address filtering.
+ * OTA type byte is XOR'd with a key derived from network ID.
+ * All OTA types have exactly two bits set (see MessageType and OTAPayload)
+ * so a key with an odd count of bits set maps every type to a non-type.
+ * Thus the default network (ID zero, key zero) and any other network reject each other's frames.
+ * Two non-default networks reject each other's frames unless their keys differ by the XOR of two types.
+ * Not perfect: hardware address filtering is the primary mechanism.
+ *
+ * Network ID zero is the default: platform's default address, no key, compatible with older units.
+ */
+class NetworkID {
+public:
+	static const uint32_t ID = SYNC_AGENT_NETWORK_ID;
+
+	static bool isDefault() { return ID == 0; }
+
+	/*
+	 * Radio address.  Bits spread by multiplicative hash so that small IDs (1, 2, ...)
+	 * still differ in many bits (better correlation properties.)
+	 */
+	static uint32_t addressBase() { return ID * 2654435761u; }
+	static uint8_t addressPrefix() { return (uint8_t) ((ID >> 24) ^ ID); }
+
+	/*
+	 * Key XOR'd into OTA type byte.  Zero for default network, else has odd count of bits set.
+	 */
+	static uint8_t typeKey() {
+		if (isDefault()) return 0;
+
+		uint8_t fold = (uint8_t) (ID ^ (ID >> 8) ^ (ID >> 16) ^ (ID >> 24));
+		return isOddParity(fold) ? fold : (uint8_t) (fold ^ 1);
+	}
+
+private:
+	static bool isOddParity(uint8_t value) {
+		bool result = false;
+		for (; value != 0; value = (uint8_t) (value >> 1))
+			if (value & 1) result = !result;
+		return result;
+	}
+};
@@ -1,3 +1,9 @@
+#pragma once
+
+#include <inttypes.h>
+
+#include "../scheduleParameters.h"	// NormalSyncPeriodDuration, config.h SYNC_AGENT_WIDE_OFFSET, SYNC_AGENT_CHANNEL_COUNT
+
 
 /*
  * Over-the-air payload.
@@ -13,12 +19,67 @@ public:
 	static const int MasterIDLength = 6;
 
 	static const int OffsetIndex = 7;
+
+	/*
+	 * Hop count shares the offset field: top 3 of its bits.
+	 * Below it, clique's sync channel (see ChannelPlan): as many bits as channel indexes need, none for one channel.
+	 * Offset never exceeds NormalSyncPeriodDuration, which must fit in the remaining bits.
+	 * Wide: 32-bit field for long sync periods.
+	 */
+#ifdef SYNC_AGENT_WIDE_OFFSET
+	static const int OffsetLength = 4;
+	static const int HopCountShift = 29;
+#else
 	static const int OffsetLength = 3;
+	static const int HopCountShift = 21;
+#endif
+	static const uint8_t MaxHopCount = 7;
 
-	static const int WorkIndex = 10;
+	static const int ChannelBits = (SYNC_AGENT_CHANNEL_COUNT > 4) ? 3
+			: (SYNC_AGENT_CHANNEL_COUNT > 2) ? 2
+			: (SYNC_AGENT_CHANNEL_COUNT > 1) ? 1
+			: 0;
+	static const int ChannelShift = HopCountShift - ChannelBits;
+
+	static const int WorkIndex = OffsetIndex + OffsetLength;
 	static const int WorkLength = 1;
 
+	// Sender's xmit power, signed dBm, so receiver knows path loss (see XmitPowerPolicy)
+	static const int XmitPowerIndex = WorkIndex + WorkLength;
+	static const int XmitPowerLength = 1;
+
+
+	static const int Length = XmitPowerIndex + XmitPowerLength;
+
+
+	/*
+	 * Compact frame: 24-bit clique tag instead of masterID.
+	 * Distinguished by distinct values of type (see CompactType...)
+	 */
+	static const int CompactTagIndex = 1;
+	static const int CompactTagLength = 3;
+
+	static const int CompactOffsetIndex = 4;
+
+	static const int CompactWorkIndex = CompactOffsetIndex + OffsetLength;
+
+	static const int CompactXmitPowerIndex = CompactWorkIndex + WorkLength;
+
+	static const int CompactLength = CompactXmitPowerIndex + XmitPowerLength;
+
+	/*
+	 * OTA type codes of compact frame.
+	 * Like MessageType, sparse and not zero, and distinct from MessageType.
+	 */
+	static const uint8_t CompactTypeMasterSync = 18;
+	static const uint8_t CompactTypeMergeSync = 36;
+	static const uint8_t CompactTypeAbandonMastership = 72;
+	static const uint8_t CompactTypeWorkSync = 144;
 
 	// Total length defined in platform/radio.h
 	// If you add a field, change that def also.
 };
+
+static_assert(SYNC_AGENT_CHANNEL_COUNT >= 1 && SYNC_AGENT_CHANNEL_COUNT <= 8, "OTA channel field holds at most 8 channels.");
+static_assert(ScheduleParameters::NormalSyncPeriodDuration < (1u << OTAPayload::ChannelShift),
+		"Sync period too long for OTA offset field, define SYNC_AGENT_WIDE_OFFSET.");
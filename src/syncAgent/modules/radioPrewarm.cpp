@@ -0,0 +1,111 @@
+
+#include <cassert>
+
+#include "radioPrewarm.h"
+#include "../globals.h"
+#include "clique.h"
+#include "../scheduleParameters.h"
+#include "../../augment/timeMath.h"
+#include "inputRecorder.h"
+
+
+
+namespace {
+
+/*
+ * Initial lead is former hand-set constant.
+ * Never less than MinLead: crystal can't start in zero time.
+ * Never more than MaxLead: a lead that long means a fault (e.g. debugger), not a slow crystal.
+ */
+DeltaTime _lead = ScheduleParameters::PowerOffToActiveDelay;
+const DeltaTime MinLead = 2;
+const DeltaTime MaxLead = ScheduleParameters::VirtualSlotDuration;
+
+/*
+ * Decrease lead by one tick after this many consecutive early crystals.
+ * Slow decrease, so crystal is rarely late.
+ */
+const ScheduleCount CountEarlyPerDecrease = 16;
+ScheduleCount countEarly = 0;
+
+bool isCrystalStarted = false;
+LongTime _memoDeadline;
+
+
+LongTime timeOfCrystalStart() {
+	return _memoDeadline - _lead;
+}
+
+void learnFromEarlyCrystal() {
+	countEarly++;
+	if (countEarly >= CountEarlyPerDecrease) {
+		countEarly = 0;
+		if (_lead > MinLead)
+			_lead--;
+	}
+}
+
+void learnFromLateCrystal(DeltaTime lateness) {
+	countEarly = 0;
+	// Plus one: lateness was measured with tick resolution
+	_lead += lateness + 1;
+	if (_lead > MaxLead)
+		_lead = MaxLead;
+}
+
+} // namespace
+
+
+
+DeltaTime RadioPrewarm::lead() { return _lead; }
+
+
+void RadioPrewarm::startBefore(LongTime deadline) {
+	assert(!radio->isPowerOn());
+	_memoDeadline = deadline;
+	syncSleeper.sleepUntil(timeOfCrystalStart());
+	radio->hfCrystalClock->start();
+	isCrystalStarted = true;
+}
+
+
+void RadioPrewarm::finish() {
+	if (!isCrystalStarted) {
+		// Cold start, nothing to learn
+		network.preamble();
+	}
+	else if (InputRecorder::flag(InputRecorder::CrystalRunning, radio->hfCrystalClock->isRunning())) {
+		learnFromEarlyCrystal();
+	}
+	else {
+		LongTime startWait = clique.schedule.nowTime();
+		network.preamble();	// wait for crystal already started
+		learnFromLateCrystal(TimeMath::clampedTimeDifference(clique.schedule.nowTime(), startWait));
+	}
+	isCrystalStarted = false;
+
+	network.prepareToTransmitOrReceive();
+	assert(radio->isPowerOn());
+}
+
+
+void RadioPrewarm::cancel() {
+	if (isCrystalStarted) {
+		network.postlude();
+		isCrystalStarted = false;
+	}
+}
+
+
+void RadioPrewarm::saveState(State* state) {
+	state->lead = _lead;
+	state->countEarly = countEarly;
+	state->isCrystalStarted = isCrystalStarted;
+}
+
+void RadioPrewarm::restoreState(const State* state) {
+	assert(state->lead >= MinLead && state->lead <= MaxLead);
+	_lead = state->lead;
+	countEarly = state->countEarly;
+	isCrystalStarted = state->isCrystalStarted;
+}
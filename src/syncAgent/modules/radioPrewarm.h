@@ -0,0 +1,55 @@
+
+#pragma once
+
+#include "../types.h"	// DeltaTime
+#include <nRF5x.h>	// LongTime
+
+
+/*
+ * Hides the start latency of HfCrystalClock behind sleep.
+ *
+ * Formerly each slot started the crystal when the slot started (synchronously, Network::preamble())
+ * and slots were lengthened by a fixed, hand-set RadioLag to cover it.
+ * Instead, knowing the deadline when a slot must be active,
+ * start the crystal a learned lead before the deadline, and keep sleeping.
+ * At the deadline, crystal is usually running and radio is ready with no dead time.
+ *
+ * Usage, for a slot active at deadline:
+ *   startBefore(deadline);
+ *   <sleep until deadline>
+ *   finish();	// radio powered on, ready to xmit or receive
+ *
+ * Lead is learned: fast increase when crystal is late, slow decrease while early.
+ * Late crystal costs a few ticks of listening, early crystal costs a few ticks of crystal current.
+ *
+ * Singleton: all members static.
+ */
+class RadioPrewarm {
+public:
+	// Current lead: ticks before a deadline that crystal is started
+	static DeltaTime lead();
+
+	/*
+	 * Sleep (radio off) until lead before deadline, then start crystal without waiting.
+	 * If already past that time, start crystal now.
+	 */
+	static void startBefore(LongTime deadline);
+
+	/*
+	 * Wait until crystal running (if it is not yet), and power on radio.
+	 * Without a prior startBefore(), a cold start (as formerly.)
+	 */
+	static void finish();
+
+	// Stop a crystal started by startBefore() that is no longer needed.
+	static void cancel();
+
+	// Learned lead, and crystal started for next deadline.  For replay (see SyncCheckpoint::resumeFromRestart.)
+	struct State {
+		DeltaTime lead;
+		ScheduleCount countEarly;
+		bool isCrystalStarted;
+	};
+	static void saveState(State* state);
+	static void restoreState(const State* state);
+};
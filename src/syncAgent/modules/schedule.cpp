@@ -5,6 +5,7 @@
 #include "../scheduleParameters.h"	// probably already included by MergeOffset
 
 #include "../logMessage.h"
+#include "inputRecorder.h"
 
 namespace {
 
@@ -16,7 +17,9 @@ LongTime messageTOA;
 /*
  * Set every SyncPoint (when SyncPeriod starts) and never elsewhere.
  * I.E. It is history that we don't rewrite.
- * Invariant: in the past
+ * Usually in the past.  But a period starts at its scheduled SyncPoint (see rollPeriodForwardToNow):
+ * if the SyncPoint timer woke early, start is a few ticks in the future until the clock reaches it.
+ * So a delta from start to now must be clamped (TimeMath::clampedTimeDifferenceToNow), never plain subtraction.
  */
 LongTime _startTimeOfSyncPeriod;
 
@@ -35,6 +38,59 @@ LongTime _startTimeOfSyncPeriod;
 LongTime _endTimeOfSyncPeriod;
 
 
+/*
+ * Estimate of drift of self's clock relative to clique's clock.
+ * Units: 1/DriftScale tick per sync period.
+ * Positive means SyncPoints of clique are later than self's (self clock is fast.)
+ *
+ * Learned from small corrections by sync messages, not used for scheduling.
+ * Known so that schedule can be projected across a long time without sync (see SyncCheckpoint.)
+ */
+int32_t _driftPerPeriod = 0;
+ScheduleCount countPeriodsSinceCorrection = 0;
+
+
+/*
+ * Statistics of rollovers later than scheduled SyncPoint (see rollPeriodForwardToNow.)
+ * Reported by log when late, and by getters.
+ */
+uint32_t _countLateSyncPoints = 0;
+uint32_t _countSkippedPeriods = 0;
+DeltaTime _maxLateness = 0;
+
+// Change to end time by last adjustBySyncMsg, negative if shortened
+int64_t _lastCorrection = 0;
+
+// Count of changes to start or end of period, wraps.  See countChanges()
+uint32_t _countChanges = 0;
+
+
+/*
+ * Update drift estimate from a correction to end time of sync period.
+ * Correction is signed: adjustedEndTime picks the nearest candidate, so drift shortens or lengthens a period.
+ * Large corrections (merging, a new master, or nearest candidate too soon) say nothing about drift: restart the estimate.
+ */
+void estimateDrift(LongTime oldEndTime, LongTime newEndTime) {
+	int64_t correction = (int64_t) (newEndTime - oldEndTime);
+
+	if (correction > (int64_t) ScheduleParameters::HalfSlotDuration
+			|| correction < - (int64_t) ScheduleParameters::HalfSlotDuration) {
+		_driftPerPeriod = 0;
+	}
+	else if (countPeriodsSinceCorrection > 0) {
+		// Exponentially weighted average, weight 1/4 to newest sample
+		int32_t sample = (int32_t) (correction * Schedule::DriftScale / countPeriodsSinceCorrection);
+		_driftPerPeriod += (sample - _driftPerPeriod) / 4;
+	}
+	// else second correction in same period, sample of zero periods
+	countPeriodsSinceCorrection = 0;
+}
+
+// Magnitude of difference of two times
+LongTime distance(LongTime time1, LongTime time2) {
+	return (time1 > time2) ? time1 - time2 : time2 - time1;
+}
+
 } // namespace
 
 
@@ -45,71 +101,118 @@ LongTime _endTimeOfSyncPeriod;
 
 
 LongTime Schedule::nowTime() {
-	return longClock->nowTime();
+	return InputRecorder::clock(longClock->nowTime());
 }
 
 void Schedule::startFreshAfterHWReset(){
 	log("Schedule reset\n");
 	longClock->reset();
-	_startTimeOfSyncPeriod = longClock->nowTime();	// Must do this to avoid assertion in rollPeriodForwardToNow
+	_startTimeOfSyncPeriod = InputRecorder::clock(longClock->nowTime());	// Must do this to avoid assertion in rollPeriodForwardToNow
+	_endTimeOfSyncPeriod = _startTimeOfSyncPeriod;	// Roll starts first period at scheduled end i.e. now
 	rollPeriodForwardToNow();
 	// Out of sync with other cliques
 }
 
 
+/*
+ * Resume a schedule remembered across a reset (see SyncCheckpoint.)
+ *
+ * Current period is a partial period ending at the projected SyncPoint of the remembered schedule.
+ * !!! Caller must sleep until that SyncPoint and roll forward before performing any slots,
+ * since slots are scheduled from startTimeOfSyncPeriod, which here is not a SyncPoint.
+ */
+void Schedule::resumeAfterHWReset(DeltaTime deltaToNextSyncPoint, int32_t driftPerPeriod){
+	log("Schedule resume\n");
+	assert(deltaToNextSyncPoint <= ScheduleParameters::NormalSyncPeriodDuration);
+	longClock->reset();
+	_startTimeOfSyncPeriod = InputRecorder::clock(longClock->nowTime());
+	_endTimeOfSyncPeriod = _startTimeOfSyncPeriod + deltaToNextSyncPoint;
+	_countChanges++;
+	_driftPerPeriod = driftPerPeriod;
+	countPeriodsSinceCorrection = 0;
+}
+
+
 /*
  * Called at wall time that should be SyncPoint.
  * That is, called when a timer expires that indicates end of sync period and time to begin next.
  *
+ * New period starts at the scheduled SyncPoint (endTimeOfSyncPeriod), not at now.
+ * Thus lateness is not a permanent phase error: the clique's SyncPoints are kept.
+ *
  * There are cases when this is called late:
  * 1) Since we can fish in the last slot before this time, and fishing code may delay us a short time,
  * this may be called a short time later than usual.
- * If not a short time, is error in algorithm.
- *
  * 2) There could be other faults that delay a call to this (timer does not expire at correct wall time.)
  * E.G. there is a mysterious delay when an invalid CRC is detected.
- *
  * 3) Also, using the debugger could delay timer expiration.
  *
- * In those cases, if the delay is not short, sync is lost
- * (the wall time of our SyncPoint not the same as other clique member's wall time of SyncPoint.)
- * But it is unavoidable for a robust algorithm.  See next paragraph.
+ * Catch up: if later than a whole period, skip the missed periods (startTimeOfSyncPeriod is the latest
+ * scheduled SyncPoint not after now.)  Bounded: at most one period's slots are then late, see isLateForSlots().
+ * Slots are scheduled from startTimeOfSyncPeriod, so a slot whose time is past gets a zero timeout.
+ *
+ * Lateness beyond LateSyncPointTolerance is counted and logged.
  *
- * FLAWED design if called late:
- *    startTimeOfSyncPeriod = endTimeOfSyncPeriod;
- *    endTimeOfSyncPeriod = startTimeOfSyncPeriod + NormalSyncPeriodDuration;
- * That yields flawed scheduling (scheduling events in the past or at zero timeout) later
- * since it leaves the startTimeOfSyncPeriod much in the past.
- * It yields setting timers for times in the past, which should expire immediately.
+ * FORMERLY (flawed): startTimeOfSyncPeriod = now.
+ * If called late, the lateness became a phase error that desynced self from its clique (or the clique, if master.)
  */
 void Schedule::rollPeriodForwardToNow() {
 
-	//LongTime startOfPreviousSyncPeriod = startTimeOfSyncPeriod;
+	LongTime now = InputRecorder::clock(longClock->nowTime());
 
-	LongTime now = longClock->nowTime();
+	trace(LogMessage::StartSyncPeriod, (uint32_t) now);
 
-	LogMessage::logStartSyncPeriod(now);
+	_startTimeOfSyncPeriod = _endTimeOfSyncPeriod;
 
-	// Starts now.  See above.  If called late, sync might be lost.
-	_startTimeOfSyncPeriod = now;
-	_endTimeOfSyncPeriod = now + ScheduleParameters::NormalSyncPeriodDuration;
+	// Usually now is equal or a little past.  If woke early, period starts in the near future.
+	if (now > _startTimeOfSyncPeriod) {
+		LongTime lateness = now - _startTimeOfSyncPeriod;
+
+		if (lateness >= ScheduleParameters::NormalSyncPeriodDuration) {
+			// Missed whole periods
+			LongTime countMissed = lateness / ScheduleParameters::NormalSyncPeriodDuration;
+			_startTimeOfSyncPeriod += countMissed * ScheduleParameters::NormalSyncPeriodDuration;
+			_countSkippedPeriods += (uint32_t) countMissed;
+			lateness -= countMissed * ScheduleParameters::NormalSyncPeriodDuration;
+			trace(LogMessage::PeriodsMissed, (uint32_t) countMissed);
+
+			// Drift accrued in missed periods too: next correction is a sample over all of them
+			if (countMissed < (LongTime) (MaximumScheduleCount - countPeriodsSinceCorrection))
+				countPeriodsSinceCorrection += (ScheduleCount) countMissed;
+			else
+				countPeriodsSinceCorrection = MaximumScheduleCount;
+		}
+
+		if (lateness > ScheduleParameters::LateSyncPointTolerance) {
+			_countLateSyncPoints++;
+			if (lateness > _maxLateness) _maxLateness = (DeltaTime) lateness;
+			trace(LogMessage::LateSyncPoint, (DeltaTime) lateness);
+		}
+	}
+	_endTimeOfSyncPeriod = _startTimeOfSyncPeriod + ScheduleParameters::NormalSyncPeriodDuration;
+	_countChanges++;
+
+	if (countPeriodsSinceCorrection < MaximumScheduleCount)
+		countPeriodsSinceCorrection++;
 
 	/*
-	 * assert startTimeOfSyncPeriod is close to nowTime().
-	 * This is called at the time that should be SyncPoint.
-	 * But since we can fish in the last slot before this time,
-	 * and fishing may delay us a short time,
-	 * this may be called a short time later than usual.
-	 * If not a short time, is error in algorithm.
-	 */
-	/*
-	 * !!! This assertion can't be stepped-in while debugging
+	 * !!! Lateness can't be avoided while debugging
 	 * since the RTC continues to run while you are stepping.
 	 */
-	//assert( TimeMath::timeDifferenceFromNow(startTimeOfSyncPeriod) < ScheduleParameters::SlotDuration );
 }
 
 
+bool Schedule::isLateForSlots() {
+	return TimeMath::clampedTimeDifferenceToNow(startTimeOfSyncPeriod()) > ScheduleParameters::MaxLatenessToPerformSlots;
+}
+
+void Schedule::countSkippedPeriod() { _countSkippedPeriods++; }
+
+uint32_t Schedule::countLateSyncPoints() { return _countLateSyncPoints; }
+uint32_t Schedule::countSkippedPeriods() { return _countSkippedPeriods; }
+DeltaTime Schedule::maxLateness() { return _maxLateness; }
+
+
 /*
  * Crux
  *
@@ -118,8 +221,7 @@ void Schedule::rollPeriodForwardToNow() {
  * - rarely, a MergeSync in Sync slot
  * - very rarely, a MasterSync in a Fish slot
  *
- * A sync message adds to ***end*** of period (farther into the future).
- * TODO not true for a MasterSync in SyncSlot?
+ * A sync message moves ***end*** of period, later or sooner (see adjustedEndTime.)
  *
  * Otherwise, for a fish slot, the calculation of the end of the fish slot
  * (based on the start) might be beyond the end of sync period?
@@ -145,30 +247,37 @@ void Schedule::adjustBySyncMsg(SyncMessage* msg) {
 	// FUTURE optimization?? If adjustedEndTime is near old endTime, forego setting it?
 	_endTimeOfSyncPeriod = adjustedEndTime(msg->deltaToNextSyncPoint);
 
+	estimateDrift(oldEndTimeOfSyncPeriod, _endTimeOfSyncPeriod);
+
+	_lastCorrection = (int64_t) (_endTimeOfSyncPeriod - oldEndTimeOfSyncPeriod);
+	_countChanges++;
+
 	// assert old startTimeOfSyncPeriod < new endTimeOfSyncPeriod  < nowTime() + 2*periodDuration
 
-	// endTime never advances backward
-	assert(_endTimeOfSyncPeriod > oldEndTimeOfSyncPeriod);
+	// endTime may move backward (shortened) but not into current activity
+	assert(_endTimeOfSyncPeriod > nowTime());
 
 	// end time never jumps too far forward from remembered start time.
 	assert( (_endTimeOfSyncPeriod - startTimeOfSyncPeriod()) <= 2* ScheduleParameters::NormalSyncPeriodDuration);
 }
 
 /*
- * ALTERNATIVE DESIGN: NOT IMPLEMENTED
- * Adjusted end time of SyncPeriod, where SyncPeriod is never shortened by much, only lengthened.
- * "By much" means: not more than one slot before current end time of SyncPeriod.
- * Here, elsewhere there must be code to insure that fishing in the last slot
- * and MergeSync transmit does not fall outside the shortened SyncPeriod.
-
-
-	DeltaTime adjustment;
-	if (senderDeltaToSyncPoint > SlotDuration) {
-		// Self is not already near end of adjusted SyncPeriod
-		adjustment = senderDeltaToSyncPoint;
- */
-/*
- * Adjusted end time of SyncPeriod, where SyncPeriod is never shortened (at all), only lengthened.
+ * Adjusted end time of SyncPeriod, in whichever direction is the shorter correction.
+ *
+ * Target SyncPoint from msg is known modulo NormalSyncPeriodDuration.
+ * Candidates: the target one period earlier, the target, and one period later.
+ * Choose the candidate nearest the current end time, that is not sooner than earliestEndTime().
+ *
+ * Small corrections go either way: master and slaves converge from both sides,
+ * with half the average correction latency than when only lengthening.
+ * A merge costs at most half a period, not an extra whole period.
+ *
+ * When shortened, activity planned for the current period must be re-planned against the new end:
+ * - FishSchedule: a fish slot now beyond the end is skipped (see FishSlot.)
+ * - CliqueMerger/MergeSlot: merge time is relative to the end (see timeOfThisMergeStart)
+ *   and CliqueMerger::adjustMergerBySyncMsg keeps the wall time of merge by the correction.
+ *
+ * FORMERLY never shortened: when target <= current end, added a whole period.
  */
 LongTime Schedule::adjustedEndTime(DeltaSync deltaSync) {
 
@@ -183,26 +292,33 @@ LongTime Schedule::adjustedEndTime(DeltaSync deltaSync) {
 	// delta < SyncPeriodDuration
 
 	LongTime toa = getMsgArrivalTime();
-	LongTime result = toa +
+	LongTime target = toa +
 			+ delta
 			- ScheduleParameters::MsgOverTheAirTimeInTicks
 			- ScheduleParameters::SenderLatency;
 
-	/*
-	 * Don't adjust end time sooner than it already is,
-	 * otherwise fishing and merging in this sync period also need adjusting.
-	 *
-	 * !!!! < or = : if we are already past sync point,
-	 * both result and timeOfNextSyncPoint() could be the same
-	 * (both deltas are zero.)
-	 */
-	if (result <= timeOfNextSyncPoint()) {
-		result += ScheduleParameters::NormalSyncPeriodDuration;
+	LongTime currentEnd = timeOfNextSyncPoint();
+	LongTime earliest = earliestEndTime();
+
+	LongTime result = 0;
+	bool isChosen = false;
+	LongTime candidate = target - ScheduleParameters::NormalSyncPeriodDuration;
+	for (uint8_t i = 0; i < 3; i++, candidate += ScheduleParameters::NormalSyncPeriodDuration) {
+		if (candidate < earliest)
+			continue;
+		if (!isChosen
+				|| distance(candidate, currentEnd) < distance(result, currentEnd)) {
+			result = candidate;
+			isChosen = true;
+		}
 	}
+	// Candidates span two periods from before target, one is always >= earliest
+	assert(isChosen);
 
-	logLongLong(toa); log(":toa\n");
-	logInt(delta); log(":offset\n");
-	logLongLong(result); log(":new period end\n");
+	trace(LogMessage::AdjustTOA, (uint32_t) toa);
+	trace(LogMessage::AdjustOffset, delta);
+	trace(LogMessage::AdjustPeriodEnd, (uint32_t) result);
+	if (result < currentEnd) trace(LogMessage::Shortened, (DeltaTime) (currentEnd - result));
 	//logInt(deltaNowToNextSyncPoint()); log(":Delta to next sync\n");
 
 	assert( (result - startTimeOfSyncPeriod()) <= 2* ScheduleParameters::NormalSyncPeriodDuration);
@@ -210,10 +326,49 @@ LongTime Schedule::adjustedEndTime(DeltaSync deltaSync) {
 }
 
 
+/*
+ * Soonest the current period may end.
+ * After the sync slot (which may be in progress, including relay subslots)
+ * and not sooner than a slot from now (time to finish the current activity, and prewarm for next sync slot.)
+ */
+LongTime Schedule::earliestEndTime() {
+	LongTime result = startTimeOfSyncPeriod()
+			+ ScheduleParameters::RealSlotDuration
+			+ ScheduleParameters::RelayExtension;
+	LongTime now = nowTime();
+	if (now > result) result = now;
+	return result + ScheduleParameters::VirtualSlotDuration;
+}
+
+
 LongTime Schedule::startTimeOfSyncPeriod(){
 	return _startTimeOfSyncPeriod;
 }
 
+int64_t Schedule::lastCorrection() { return _lastCorrection; }
+
+uint32_t Schedule::countChanges() { return _countChanges; }
+
+int32_t Schedule::driftPerPeriod() {
+	return _driftPerPeriod;
+}
+
+void Schedule::saveState(State* state) {
+	state->startTimeOfSyncPeriod = _startTimeOfSyncPeriod;
+	state->endTimeOfSyncPeriod = _endTimeOfSyncPeriod;
+	state->driftPerPeriod = _driftPerPeriod;
+	state->countPeriodsSinceCorrection = countPeriodsSinceCorrection;
+}
+
+void Schedule::restoreState(const State* state) {
+	assert(state->startTimeOfSyncPeriod <= state->endTimeOfSyncPeriod);
+	_startTimeOfSyncPeriod = state->startTimeOfSyncPeriod;
+	_endTimeOfSyncPeriod = state->endTimeOfSyncPeriod;
+	_countChanges++;
+	_driftPerPeriod = state->driftPerPeriod;
+	countPeriodsSinceCorrection = state->countPeriodsSinceCorrection;
+}
+
 
 
 
@@ -234,7 +389,7 @@ DeltaTime  Schedule::deltaNowToNextSyncPoint() {
 	return result;
 }
 
-// Different: backwards from others: from past time to now
+// Different: backwards from others: from past time to now.  Zero while start is still in the future (woke early.)
 DeltaTime  Schedule::deltaPastSyncPointToNow() {
 	DeltaTime result = TimeMath::clampedTimeDifferenceToNow(startTimeOfSyncPeriod());
 	/*
@@ -260,9 +415,15 @@ LongTime Schedule::timeOfNextSyncPoint() {
  *
  * offset comes from cliqueMerger.mergeOffset
  */
+/*
+ * Relative to end of period, not start: if end was adjusted (see CliqueMerger::adjustMergerBySyncMsg)
+ * the offset is relative to the adjusted schedule.
+ * Unadjusted, same as startTimeOfSyncPeriod() + offset.
+ * Result may be in the past (period shortened past the merge.)
+ */
 LongTime Schedule::timeOfThisMergeStart(DeltaTime offset) {
 	LongTime result;
-	result = startTimeOfSyncPeriod() + offset;
+	result = timeOfNextSyncPoint() - ScheduleParameters::NormalSyncPeriodDuration + offset;
 	assert(result < _endTimeOfSyncPeriod);
 	return result;
 }
@@ -275,7 +436,7 @@ DeltaTime Schedule::deltaToThisMergeStart(const MergeOffset* const offset){
 
 
 void Schedule::recordMsgArrivalTime() {
-	messageTOA = longClock->nowTime();
+	messageTOA = InputRecorder::clock(longClock->nowTime());
 }
 
 LongTime Schedule::getMsgArrivalTime() {
@@ -80,13 +80,63 @@ public:
 	 */
 	static void startFreshAfterHWReset();
 
+	/*
+	 * Alternative to startFreshAfterHWReset.
+	 * Resume a schedule projected across a reset, with SyncPoint deltaToNextSyncPoint from now.
+	 */
+	static void resumeAfterHWReset(DeltaTime deltaToNextSyncPoint, int32_t driftPerPeriod);
+
 	// FUTURE static void resumeAfterPowerRestored();
 
 	static void rollPeriodForwardToNow();
+
+	/*
+	 * Is now too late in current period to perform its slots?
+	 * (Rolled late, e.g. a long dispatch in last fish slot.)
+	 */
+	static bool isLateForSlots();
+
+	/*
+	 * Statistics of lateness: count of late SyncPoints,
+	 * count of periods skipped (by catching up or by isLateForSlots), and max lateness in ticks.
+	 */
+	static uint32_t countLateSyncPoints();
+	static uint32_t countSkippedPeriods();
+	static DeltaTime maxLateness();
+	// Caller skipped slots of current period
+	static void countSkippedPeriod();
 	static void adjustBySyncMsg(SyncMessage* msg);
 	static LongTime adjustedEndTime(DeltaSync senderDeltaToSyncPoint);	// <<<<
+	static LongTime earliestEndTime();
+	// Change to end of period by last adjustBySyncMsg, negative if shortened
+	static int64_t lastCorrection();
+
+	/*
+	 * Changes whenever start or end of period changes.
+	 * Times calculated from schedule are stale when it differs from when they were calculated (see SyncSleeper.)
+	 */
+	static uint32_t countChanges();
 	static LongTime startTimeOfSyncPeriod();
 
+	/*
+	 * Estimated drift of self clock relative to clique, in 1/DriftScale ticks per sync period.
+	 */
+	static const int32_t DriftScale = 256;
+	static int32_t driftPerPeriod();
+
+	/*
+	 * Current period and drift estimate, for replay from a restart of input recording (see InputRecorder.)
+	 * Unlike a checkpoint, not projected: restored into the same run of the clock.
+	 */
+	struct State {
+		LongTime startTimeOfSyncPeriod;
+		LongTime endTimeOfSyncPeriod;
+		int32_t driftPerPeriod;
+		ScheduleCount countPeriodsSinceCorrection;
+	};
+	static void saveState(State* state);
+	static void restoreState(const State* state);
+
 	/*
 	 * Deltas from past time to now.
 	 *
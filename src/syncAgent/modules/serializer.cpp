@@ -3,9 +3,12 @@
 #include <cstring>	// memcpy
 #include <nRF5x.h>	// MaxDeltaTime
 
+#include "../../config.h"
 #include "serializer.h"
 
 #include "otaPacket.h"
+#include "networkID.h"
+#include "channelPlan.h"
 
 
 /*
@@ -44,61 +47,184 @@ uint8_t radioBufferSize;
 
 
 
+/*
+ * Layout of frame, chosen by OTA type byte.
+ * Full and compact frames differ only in length of masterID field (and so indexes of later fields.)
+ */
+struct FrameLayout {
+	int masterIndex;
+	int masterLength;
+	int offsetIndex;
+	int workIndex;
+	int xmitPowerIndex;
+};
+
+const FrameLayout FullLayout = {
+		OTAPayload::MasterIndex, OTAPayload::MasterIDLength,
+		OTAPayload::OffsetIndex,
+		OTAPayload::WorkIndex,
+		OTAPayload::XmitPowerIndex };
+
+const FrameLayout CompactLayout = {
+		OTAPayload::CompactTagIndex, OTAPayload::CompactTagLength,
+		OTAPayload::CompactOffsetIndex,
+		OTAPayload::CompactWorkIndex,
+		OTAPayload::CompactXmitPowerIndex };
+
+
+#ifdef SYNC_AGENT_COMPACT_OTA
+const FrameLayout& OutwardLayout = CompactLayout;
+#else
+const FrameLayout& OutwardLayout = FullLayout;
+#endif
+
+
+bool isCompactType(uint8_t receivedType) {
+	return      (receivedType == OTAPayload::CompactTypeMasterSync)
+			|| (receivedType == OTAPayload::CompactTypeMergeSync)
+			|| (receivedType == OTAPayload::CompactTypeAbandonMastership)
+			|| (receivedType == OTAPayload::CompactTypeWorkSync);
+}
+
+MessageType messageTypeFromCompactType(uint8_t compactType) {
+	switch (compactType) {
+	case OTAPayload::CompactTypeMasterSync: return MasterSync;
+	case OTAPayload::CompactTypeMergeSync: return MergeSync;
+	case OTAPayload::CompactTypeAbandonMastership: return AbandonMastership;
+	default:
+		assert(compactType == OTAPayload::CompactTypeWorkSync);
+		return WorkSync;
+	}
+}
+
+#ifdef SYNC_AGENT_COMPACT_OTA
+uint8_t compactTypeFromMessageType(MessageType type) {
+	switch (type) {
+	case MasterSync: return OTAPayload::CompactTypeMasterSync;
+	case MergeSync: return OTAPayload::CompactTypeMergeSync;
+	case AbandonMastership: return OTAPayload::CompactTypeAbandonMastership;
+	default:
+		assert(type == WorkSync);
+		return OTAPayload::CompactTypeWorkSync;
+	}
+}
+#endif
+
+/*
+ * Either frame, and it fits in radio buffer.
+ * A full frame can be received only if radio buffer is large enough.
+ */
+bool isReceivedTypeAnyFrame(uint8_t receivedType) {
+	if (isCompactType(receivedType))
+		return radioBufferSize >= OTAPayload::CompactLength;
+	else
+		return SyncMessage::isReceivedTypeASyncType(receivedType)
+				&& radioBufferSize >= OTAPayload::Length;
+}
+
+/*
+ * Type byte as received, unkeyed by network ID.
+ * A frame from a foreign network (different key) usually yields an invalid type.
+ */
+uint8_t receivedType() {
+	return radioBufferPtr[0] ^ NetworkID::typeKey();
+}
+
+void serializeType(uint8_t otaType) {
+	radioBufferPtr[0] = otaType ^ NetworkID::typeKey();
+}
+
+const FrameLayout& inwardLayout() {
+	return isCompactType(receivedType()) ? CompactLayout : FullLayout;
+}
+
+
+
 // suppress compiler warning for pointer arith
 #pragma GCC diagnostic ignored "-Wpointer-arith"
 
 
-void unserializeWorkIntoCommon() {
+void unserializeWorkIntoCommon(const FrameLayout& layout) {
 	memcpy( (void*) &Serializer::inwardCommonSyncMsg.work,	// dest
-			(void*) radioBufferPtr + OTAPayload::WorkIndex,	// src
+			(void*) radioBufferPtr + layout.workIndex,	// src
 			OTAPayload::WorkLength);
 }
 void serializeWorkCommonIntoStream(SyncMessage& msg){
-	memcpy( (void*) radioBufferPtr + OTAPayload::WorkIndex, 	// dest
+	memcpy( (void*) radioBufferPtr + OutwardLayout.workIndex, 	// dest
 			(void*) &msg.work,	// src
 			OTAPayload::WorkLength);
 }
 
+// Signed byte
+void unserializeXmitPowerIntoCommon(const FrameLayout& layout) {
+	Serializer::inwardCommonSyncMsg.xmitPower = (int8_t) radioBufferPtr[layout.xmitPowerIndex];
+}
+void serializeXmitPowerCommonIntoStream(SyncMessage& msg){
+	radioBufferPtr[OutwardLayout.xmitPowerIndex] = (uint8_t) msg.xmitPower;
+}
+
 // Matched pairs
-void unserializeMasterIDIntoCommon() {
+void unserializeMasterIDIntoCommon(const FrameLayout& layout) {
 	assert(sizeof(Serializer::inwardCommonSyncMsg.masterID)>=OTAPayload::MasterIDLength);
-	Serializer::inwardCommonSyncMsg.masterID = 0; // ensure MSB two bytes are zero.
-	// Fill LSB 6 bytes of a 64-bit
+	Serializer::inwardCommonSyncMsg.masterID = 0; // ensure MSB bytes are zero.
+	// Fill LSB 6 (or 3 for tag) bytes of a 64-bit
 	memcpy( (void*) &Serializer::inwardCommonSyncMsg.masterID,	// dest
-			(void*) radioBufferPtr + OTAPayload::MasterIndex,	// src
-			OTAPayload::MasterIDLength);
+			(void*) radioBufferPtr + layout.masterIndex,	// src
+			layout.masterLength);
 }
 
 void serializeMasterIDCommonIntoStream(SyncMessage& msg) {
-	// Send LSB 6 bytes of 64-bit
-	memcpy( (void*) radioBufferPtr + OTAPayload::MasterIndex, 	// dest
+	// A tag has zero MSB bytes
+	assert(OutwardLayout.masterLength == OTAPayload::MasterIDLength || (msg.masterID >> 24) == 0);
+	// Send LSB bytes of 64-bit
+	memcpy( (void*) radioBufferPtr + OutwardLayout.masterIndex, 	// dest
 			(void*) &msg.masterID,	// src
-			OTAPayload::MasterIDLength);
+			OutwardLayout.masterLength);
 }
 
-DeltaTime unserializeOffset() {
+// Offset field, including hop count and channel in its top bits
+DeltaTime unserializeOffsetField(const FrameLayout& layout) {
 	// assert sizeof(DeltaTime) >= OTAPayload::OffsetLength
-	// 24-bits OTA, little-endian into LSB three bytes of a 32-bit OSTime
-	// FUTURE, code for 32-bit OSClock
+	// 24-bits (32-bits wide) OTA, little-endian into LSB bytes of a 32-bit OSTime
 
 	// !!! // Ensure MSB byte is zero because we only copy in LSB
 	DeltaTime result = 0;
 	memcpy( (void*) &result, 	// dest
-			(void*) radioBufferPtr + OTAPayload::OffsetIndex,	// src
+			(void*) radioBufferPtr + layout.offsetIndex,	// src
 			OTAPayload::OffsetLength);	// count
 	return result;
 }
 
+DeltaTime unserializeOffset(const FrameLayout& layout) {
+	return unserializeOffsetField(layout) & ((1u << OTAPayload::ChannelShift) - 1);
+}
 
-void unserializeOffsetIntoCommon() {
-	DeltaTime otaDeltaSync = unserializeOffset();
+uint8_t unserializeHopCount(const FrameLayout& layout) {
+	return (uint8_t) (unserializeOffsetField(layout) >> OTAPayload::HopCountShift);
+}
+
+uint8_t unserializeChannel(const FrameLayout& layout) {
+	return (uint8_t) ((unserializeOffsetField(layout) >> OTAPayload::ChannelShift)
+			& ((1u << OTAPayload::ChannelBits) - 1));
+}
+
+
+void unserializeOffsetIntoCommon(const FrameLayout& layout) {
+	DeltaTime otaDeltaSync = unserializeOffset(layout);
 	Serializer::inwardCommonSyncMsg.deltaToNextSyncPoint.set(otaDeltaSync);
 	// assert deltaToNextSyncPoint is set to a valid value
+	Serializer::inwardCommonSyncMsg.hopCount = unserializeHopCount(layout);
+	Serializer::inwardCommonSyncMsg.channel = unserializeChannel(layout);
 }
 
 void serializeOffsetCommonIntoStream(SyncMessage& msg) {
-	memcpy( (void*) radioBufferPtr + OTAPayload::OffsetIndex, 	// dest
-			(void*) &msg.deltaToNextSyncPoint,	// src
+	assert(msg.hopCount <= OTAPayload::MaxHopCount);
+	assert(msg.channel < ChannelPlan::CountChannels);
+	DeltaTime field = msg.deltaToNextSyncPoint.get()
+			| ((DeltaTime) msg.channel << OTAPayload::ChannelShift)
+			| ((DeltaTime) msg.hopCount << OTAPayload::HopCountShift);
+	memcpy( (void*) radioBufferPtr + OutwardLayout.offsetIndex, 	// dest
+			(void*) &field,	// src
 			OTAPayload::OffsetLength);
 }
 
@@ -106,12 +232,16 @@ void serializeOffsetCommonIntoStream(SyncMessage& msg) {
 #pragma GCC diagnostic pop
 
 void unserializeIntoCommonSyncMessage() {
-	MessageType msgType = (MessageType) radioBufferPtr[0];
-	// already assert isReceivedTypeASyncType
-	Serializer::inwardCommonSyncMsg.type = msgType;
-	unserializeMasterIDIntoCommon();
-	unserializeOffsetIntoCommon();
-	unserializeWorkIntoCommon();
+	uint8_t otaType = receivedType();
+	// already assert isReceivedTypeAnyFrame
+	const FrameLayout& layout = inwardLayout();
+	Serializer::inwardCommonSyncMsg.type = isCompactType(otaType) ?
+			messageTypeFromCompactType(otaType)
+			: (MessageType) otaType;
+	unserializeMasterIDIntoCommon(layout);
+	unserializeOffsetIntoCommon(layout);
+	unserializeWorkIntoCommon(layout);
+	unserializeXmitPowerIntoCommon(layout);
 }
 
 // FUTURE only unserializeOffset() once
@@ -120,7 +250,7 @@ void unserializeIntoCommonSyncMessage() {
  *
  * To protect against malice broadcasters, and failure of CRC to detect multiple bit errors,
  * enforce algorithm's constraints on DeltaSync,
- * and valid MessageType
+ * valid MessageType, and channel in plan
  *
  * This should be rare, since CRC was valid.
  * It would take multiple bit errors to corrupt message type and still have valid CRC?
@@ -134,15 +264,20 @@ void unserializeIntoCommonSyncMessage() {
  */
 bool isOTABufferAlgorithmicallyValid() {
 	bool result = true;
-	if (! SyncMessage::isReceivedTypeASyncType(radioBufferPtr[0])) {
+	if (! isReceivedTypeAnyFrame(receivedType())) {
+		// Garbled, or from foreign network on a platform without address filtering
 		log("Invalid message type\n");
 		logInt(radioBufferPtr[0]);
 		result = false;
 	}
-	if (! DeltaSync::isValidValue(unserializeOffset())) {
+	else if (! DeltaSync::isValidValue(unserializeOffset(inwardLayout()))) {
 		// already logged
 		result = false;
 	}
+	else if (unserializeChannel(inwardLayout()) >= ChannelPlan::CountChannels) {
+		log("Invalid channel\n");
+		result = false;
+	}
 
 	return result;
 }
@@ -191,7 +326,7 @@ SyncMessage* Serializer::unserialize() {
 
 bool Serializer::bufferIsSane(){
 	// FUTURE other validity checks?
-	return SyncMessage::isReceivedTypeASyncType(radioBufferPtr[0]);
+	return isReceivedTypeAnyFrame(receivedType());
 }
 
 
@@ -199,12 +334,24 @@ bool Serializer::bufferIsSane(){
 
 
 void Serializer::serializeOutwardCommonSyncMessage() {
-	radioBufferPtr[0] = outwardCommonSyncMsg.type;	// 1
+#ifdef SYNC_AGENT_COMPACT_OTA
+	serializeType(compactTypeFromMessageType(outwardCommonSyncMsg.type));	// 1
+	serializeMasterIDCommonIntoStream(outwardCommonSyncMsg);	// 3
+	serializeOffsetCommonIntoStream(outwardCommonSyncMsg);	// 3 (4 wide)
+	serializeWorkCommonIntoStream(outwardCommonSyncMsg);	// 1
+	serializeXmitPowerCommonIntoStream(outwardCommonSyncMsg);	// 1
+
+	// Size of serialized message equals size fixed length payload of the wireless protocol
+	static_assert(Radio::FixedPayloadCount == OTAPayload::CompactLength, "Protocol payload length mismatch.");
+#else
+	serializeType(outwardCommonSyncMsg.type);	// 1
 	serializeMasterIDCommonIntoStream(outwardCommonSyncMsg);	// 6
-	serializeOffsetCommonIntoStream(outwardCommonSyncMsg);	// 3
+	serializeOffsetCommonIntoStream(outwardCommonSyncMsg);	// 3 (4 wide)
 	serializeWorkCommonIntoStream(outwardCommonSyncMsg);	// 1
+	serializeXmitPowerCommonIntoStream(outwardCommonSyncMsg);	// 1
 
 	// Size of serialized message equals size fixed length payload of the wireless protocol
-	static_assert(Radio::FixedPayloadCount == 11, "Protocol payload length mismatch.");
+	static_assert(Radio::FixedPayloadCount == OTAPayload::Length, "Protocol payload length mismatch.");
+#endif
 }
 
@@ -11,8 +11,9 @@
  *
  * Knows order and size of data elements in stream (message payload.)
  * type: 1
- * masterID: 6
+ * masterID: 6  (3 in compact frame, a clique tag, see CliqueTag)
  * syncOffset: 3   (OSTime is 24-bit. 2 is max of 128k ticks)
+ * work: 1
  *
  * !!! This assumes:
  * - the radio is half-duplex (can't xmit and receive at the same time)
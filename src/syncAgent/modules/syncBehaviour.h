@@ -9,6 +9,7 @@
  */
 
 #include "../logMessage.h"
+#include "inputRecorder.h"
 
 
 class SyncBehaviour {
@@ -46,22 +47,47 @@ public:
 		bool doesMsgKeepSynch;
 
 		// Most likely case first
-		if (clique.isMsgFromMyClique(msg->masterID)) {
+		if (clique.isMsgFromMyClique(msg->masterID) && !clique.isMsgFromUpstream(msg)) {
+			/*
+			 * Mesh: relayed from self or a peer, downstream.  Not adjust schedule.
+			 * Master still counts it as heard sync (needn't xmit again soon.)
+			 */
+			trace(LogMessage::SyncFromDownstream, (uint32_t) msg->masterID);
+			// Downstream member must hear self
+			xmitPowerPolicy.heardMember(msg->xmitPower, InputRecorder::signalStrength(radio->receivedSignalStrength()));
+			if (clique.isSelfMaster())
+				clique.heardSync();
+			doesMsgKeepSynch = false;
+		}
+		else if (clique.isMsgFromMyClique(msg->masterID)) {
 			/*
 			 * Cases:
 			 * - Master is MasterSync ing Slave self
 			 * - Master or Slave fished another better clique and is MergeSync ing self
 			 * - Slave is WorkSync ing Master or Slave self
 			 */
-			log("Sync from my clique (master or slave)\n");
+			trace(LogMessage::SyncFromMyClique, (uint32_t) msg->masterID);
+			xmitPowerPolicy.heardMember(msg->xmitPower, InputRecorder::signalStrength(radio->receivedSignalStrength()));
 			// WAS clique.changeBySyncMessage(msg);
 			handleSyncMsg(msg);
 			clique.heardSync();
 			doesMsgKeepSynch = true;
 		}
+		else if (clique.isOtherCliqueBetter(msg->masterID)
+				&& linkQualityTable.shouldDefer(msg->masterID)) {
+			/*
+			 * Better master, but marginal link: following it would soon drop out and re-elect.
+			 * Includes a former master that self succeeded after dropout:
+			 * rejoin only after its link recovers (hysteresis, not flapping.)
+			 * Meanwhile a better link (e.g. via a member of that clique, or a relay) may merge the cliques.
+			 * If none does, self follows over the marginal link after a few deferrals (see LinkQualityTable.)
+			 */
+			trace(LogMessage::SyncFromBetterUnreliable, (uint32_t) msg->masterID);
+			doesMsgKeepSynch = false;
+		}
 		else if (clique.isOtherCliqueBetter(msg->masterID)) {
 			// Strictly better
-			log("Better master\n");
+			trace(LogMessage::SyncFromBetter, (uint32_t) msg->masterID);
 			handleSyncMsg(msg);
 			clique.heardSync();
 			doesMsgKeepSynch = true;
@@ -78,7 +104,7 @@ public:
 			 * they should eventually hear my clique master's sync and relinquish mastership.
 			 */
 			// If it is WorkSync, we acted on the work but not the sync???
-			logWorseSync();
+			logWorseSync(msg);
 			// !!! SyncMessage does not keep me in sync: not dropoutMonitor.heardSync();
 			doesMsgKeepSynch = false;
 		}
@@ -122,7 +148,7 @@ public:
 
 
 	// DEBUG only, no substantive effect
-	static void logWorseSync() {
+	static void logWorseSync(SyncMessage* msg) {
 		// FUTURE: for now this is just logging, in future will record history
 		if (clique.isSelfMaster()) {
 			/*
@@ -130,7 +156,7 @@ public:
 			 * Since I am still alive, they should not be assuming mastership.
 			 * Could be assymetric communication (I can hear they, they cannot hear me.)
 			 */
-			log("Worse sync while self is master.\n");
+			trace(LogMessage::SyncFromWorseWhileMaster, (uint32_t) msg->masterID);
 		}
 		else { // self is slave
 			/*
@@ -141,7 +167,7 @@ public:
 			// FUTURE: if msg.masterID < myID(), I should assume mastership instead of sender
 			// FUTURE: if msg.masterID > myID() record msg.masterID in my historyOfMasters
 			// so when I discover dropout, I will defer to msg.masterID
-			log("Worse sync while self is slave.\n");
+			trace(LogMessage::SyncFromWorseWhileSlave, (uint32_t) msg->masterID);
 		}
 	}
 };
@@ -0,0 +1,200 @@
+
+#include <cassert>
+#include <string.h>	// memset, memcpy
+#include <stddef.h>	// offsetof
+
+#include "syncCheckpoint.h"
+#include "../globals.h"
+#include "clique.h"
+#include "../scheduleParameters.h"
+#include "../policy/policyParameters.h"
+#include "../../augment/crc.h"
+#include "../../augment/random.h"
+#include "inputRecorder.h"
+
+
+
+namespace {
+
+/*
+ * Change when layout changes, so an older checkpoint is not misread.
+ */
+const uint8_t CheckpointVersion = 3;	// 2: fish counters are SlotCount, 3: channel
+
+/*
+ * Fixed width fields, copied whole.
+ * Only read back by the same build (layout guarded by version and CRC), so padding and endianness don't matter.
+ */
+struct Checkpoint {
+	uint8_t version;
+	SystemID masterID;
+	uint8_t channel;
+	DeltaTime deltaPastSyncPoint;
+	int32_t driftPerPeriod;
+	SyncRecoveryFishPolicy::State fishState;
+	uint16_t crc;
+};
+
+ScheduleCount countPeriodsSinceSave = 0;
+
+
+#ifdef SYNC_AGENT_RECORD_INPUTS
+/*
+ * State recorded at a restart of input recording.
+ * Checkpoint first, then what a checkpoint projects or lacks: exact period, crystal prewarmed for next sync slot,
+ * save count, random sequence.
+ * Read back only by replay of the same build.
+ */
+struct RestartState {
+	Checkpoint checkpoint;
+	Schedule::State schedule;
+	RadioPrewarm::State prewarm;
+	ScheduleCount countPeriodsSinceSave;
+	RandState rand;
+};
+#endif
+
+
+uint16_t crcOf(const Checkpoint* checkpoint) {
+	// CRC over all but trailing crc field
+	return crc16((const uint8_t*) checkpoint, offsetof(Checkpoint, crc));
+}
+
+
+bool readValidCheckpoint(Checkpoint* checkpoint) {
+	if (InputRecorder::retainedSize(RetainedMemory::size()) < sizeof(Checkpoint))
+		return false;
+
+	// Content may be arbitrary, e.g. after power on reset
+	RetainedMemory::read((uint8_t*) checkpoint, sizeof(Checkpoint));
+	InputRecorder::retainedBytes((const uint8_t*) checkpoint, sizeof(Checkpoint));
+	return checkpoint->version == CheckpointVersion
+			&& checkpoint->crc == crcOf(checkpoint);
+}
+
+
+/*
+ * Project remembered schedule forward by elapsed ticks.
+ *
+ * Sync periods, as measured by self clock, are NormalSyncPeriodDuration plus drift.
+ * Returns ticks from now to next projected SyncPoint.
+ */
+DeltaTime projectedDeltaToNextSyncPoint(DeltaTime deltaPastSyncPoint, uint64_t elapsedTicks, int32_t driftPerPeriod) {
+	// Scaled by DriftScale for sub-tick precision of drift
+	int64_t scaledPeriod = (int64_t) ScheduleParameters::NormalSyncPeriodDuration * Schedule::DriftScale + driftPerPeriod;
+	assert(scaledPeriod > 0);
+	int64_t scaledSincePastSyncPoint = (int64_t) (deltaPastSyncPoint + elapsedTicks) * Schedule::DriftScale;
+
+	int64_t scaledRemainder = scaledPeriod - (scaledSincePastSyncPoint % scaledPeriod);
+	DeltaTime result = (DeltaTime) (scaledRemainder / Schedule::DriftScale);
+
+	// Drift may lengthen a projected period slightly past normal.  Not significant.
+	if (result > ScheduleParameters::NormalSyncPeriodDuration)
+		result = ScheduleParameters::NormalSyncPeriodDuration;
+	return result;
+}
+
+void makeCheckpoint(Checkpoint* checkpoint, DeltaTime deltaPastSyncPoint) {
+	// Zero padding so CRC is deterministic
+	memset(checkpoint, 0, sizeof(*checkpoint));
+
+	checkpoint->version = CheckpointVersion;
+	checkpoint->masterID = clique.getMasterID();
+	checkpoint->channel = clique.channel();
+	checkpoint->deltaPastSyncPoint = deltaPastSyncPoint;
+	checkpoint->driftPerPeriod = clique.schedule.driftPerPeriod();
+	fishPolicy.saveState(&checkpoint->fishState);
+	checkpoint->crc = crcOf(checkpoint);
+}
+
+} // namespace
+
+
+
+
+void SyncCheckpoint::save() {
+	if (InputRecorder::retainedSize(RetainedMemory::size()) < sizeof(Checkpoint))
+		return;
+
+	Checkpoint checkpoint;
+	makeCheckpoint(&checkpoint, clique.schedule.deltaPastSyncPointToNow());
+
+	RetainedMemory::write((const uint8_t*) &checkpoint, sizeof(checkpoint));
+	countPeriodsSinceSave = 0;
+	log("Checkpoint saved\n");
+}
+
+
+void SyncCheckpoint::periodicSave() {
+	countPeriodsSinceSave++;
+	if (countPeriodsSinceSave >= Policy::CountSyncPeriodsPerCheckpoint)
+		save();
+
+#ifdef SYNC_AGENT_RECORD_INPUTS
+	/*
+	 * Restart input recording.
+	 * Not reading clock (it would be an input before the restart): called at SyncPoint, just rolled.
+	 */
+	RestartState state;
+	// Zero padding so recording is deterministic
+	memset(&state, 0, sizeof(state));
+	makeCheckpoint(&state.checkpoint, 0);
+	clique.schedule.saveState(&state.schedule);
+	radioPrewarm.saveState(&state.prewarm);
+	state.countPeriodsSinceSave = countPeriodsSinceSave;
+	randSaveState(&state.rand);
+	InputRecorder::restart((const uint8_t*) &state, sizeof(state));
+#endif
+}
+
+
+#ifdef SYNC_AGENT_RECORD_INPUTS
+void SyncCheckpoint::resumeFromRestart(const uint8_t* bytes, uint16_t count) {
+	RestartState state;
+	assert(count == sizeof(state));
+	memcpy(&state, bytes, sizeof(state));
+	assert(state.checkpoint.version == CheckpointVersion);
+
+	log("Resume from restart\n");
+	clique.initFromCheckpoint(state.checkpoint.masterID, state.checkpoint.channel);
+	clique.schedule.restoreState(&state.schedule);
+	radioPrewarm.restoreState(&state.prewarm);
+	fishPolicy.restoreState(&state.checkpoint.fishState);
+	countPeriodsSinceSave = state.countPeriodsSinceSave;
+	randRestoreState(&state.rand);
+}
+#endif
+
+
+bool SyncCheckpoint::restore() {
+	Checkpoint checkpoint;
+	uint64_t elapsedTicks = 0;
+
+	if (!readValidCheckpoint(&checkpoint))
+		return false;
+
+	// Without elapsed time, phase is unknown
+	bool isElapsedKnown = RetainedMemory::ticksSinceWrite(&elapsedTicks);
+	if (!InputRecorder::retainedAge(isElapsedKnown, elapsedTicks))
+		return false;
+
+	uint64_t elapsedPeriods = elapsedTicks / ScheduleParameters::NormalSyncPeriodDuration;
+	if (elapsedPeriods > Policy::MaxCheckpointAgeSyncPeriods) {
+		log("Checkpoint too old\n");
+		return false;
+	}
+
+	log("Checkpoint restore\n");
+	clique.initFromCheckpoint(checkpoint.masterID, checkpoint.channel);
+	clique.schedule.resumeAfterHWReset(
+			projectedDeltaToNextSyncPoint(checkpoint.deltaPastSyncPoint, elapsedTicks, checkpoint.driftPerPeriod),
+			checkpoint.driftPerPeriod);
+
+	if (elapsedPeriods <= Policy::MaxCheckpointAgeToResumeFishing)
+		fishPolicy.restoreState(&checkpoint.fishState);
+	else
+		fishPolicy.reset();
+
+	countPeriodsSinceSave = 0;
+	return true;
+}
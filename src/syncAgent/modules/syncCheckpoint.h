@@ -0,0 +1,59 @@
+
+#pragma once
+
+#include <inttypes.h>
+
+#include "../../config.h"	// SYNC_AGENT_RECORD_INPUTS
+
+
+/*
+ * Checkpoint of sync state, retained across an mcu reset.
+ *
+ * Motivation: harvested power.
+ * A solar powered unit browns out every dusk and resets every dawn.
+ * Without a checkpoint, every unit starts fresh as master of its own clique
+ * and the network must rediscover itself by fishing (many sync periods.)
+ * With a checkpoint, a unit listens first where its old sync slot should be,
+ * projected forward by elapsed time, and resyncs in a few sync periods.
+ *
+ * Saves:
+ * - masterID and channel
+ * - phase: ticks since last SyncPoint
+ * - drift estimate of self clock relative to clique (see Schedule)
+ * - fish history
+ * protected by a CRC.
+ *
+ * Restores only if:
+ * - CRC and version valid
+ * - platform knows elapsed time since save (see RetainedMemory)
+ * - checkpoint not too old (see Policy)
+ *
+ * Singleton: all members static.
+ */
+class SyncCheckpoint {
+public:
+	static void save();
+
+	/*
+	 * Called once, after hw reset, instead of Clique::init().
+	 * Returns true if clique and schedule resumed from checkpoint.
+	 * Returns false and has no effect otherwise.
+	 */
+	static bool restore();
+
+	/*
+	 * Called every sync period, at SyncPoint.  Saves occasionally.
+	 * Restarts input recording every time (see InputRecorder.)
+	 */
+	static void periodicSave();
+
+#ifdef SYNC_AGENT_RECORD_INPUTS
+	/*
+	 * Replay only: resume state recorded by periodicSave, instead of restore() and loop's partial first period.
+	 * Restores clique, schedule, crystal prewarm, fish history, and random generator.
+	 * Other state (role and merger, policies, dropout and link quality) is as after init:
+	 * where it differs from the recorded unit's, replay diverges.
+	 */
+	static void resumeFromRestart(const uint8_t* state, uint16_t count);
+#endif
+};
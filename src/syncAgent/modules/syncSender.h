@@ -11,22 +11,24 @@
  * or in the middle of a sync period (omit listening in the fishSlot)?
  */
 
-#include <nRF5x.h>  // myID()
+#include <nRF5x.h>
+#include "cliqueTag.h"
 
 #include "../logMessage.h"
+#include "inputRecorder.h"
 
 
 class SyncSender {
 public:
 
 	static void sendMasterSync() {
-		log(LogMessage::SendMasterSync);
+		trace(LogMessage::SendMasterSync);
 
 		/*
 		 * Make the common SyncMessage, having:
 		 * - type MasterSync
 		 * - forwardOffset unsigned delta now to next SyncPoint
-		 * - self ID
+		 * - self ID (or tag)
 		 */
 		/*
 		 * Since we are in sync slot near front of sync period, offset should (0, NormalSyncPeriodDuration)
@@ -42,7 +44,7 @@ public:
 		// FUTURE assert we are not xmitting sync past end of syncSlot?
 		// i.e. calculations are rapid and sync slot not too short?
 
-		serializer.outwardCommonSyncMsg.makeMasterSync(rawOffset, myID());
+		serializer.outwardCommonSyncMsg.makeMasterSync(rawOffset, CliqueTag::selfMasterID());
 		sendPrefabricatedMessage();
 
 		// Uncomment this to experimentally determine send latency.
@@ -50,8 +52,22 @@ public:
 	}
 
 
+	/*
+	 * Slave relays sync from upstream (SYNC_AGENT_RELAY_MESH.)
+	 * Like MasterSync, but identifying clique master, not self.
+	 * Offset calculated now, from self's schedule just adjusted by upstream sync:
+	 * that corrects for the delay from upstream xmit to this relay.
+	 */
+	static void sendRelaySync() {
+		trace(LogMessage::SendRelaySync);
+		DeltaTime rawOffset = clique.schedule.deltaNowToNextSyncPoint();
+		serializer.outwardCommonSyncMsg.makeMasterSync(rawOffset, clique.getMasterID());
+		sendPrefabricatedMessage();
+	}
+
+
 	static void sendMergeSync() {
-		log(LogMessage::SendMergeSync);
+		trace(LogMessage::SendMergeSync);
 
 		// cliqueMerger knows how to make global outwardCommonSyncMsg into a MergeSync
 		syncAgent.cliqueMerger.makeMergeSync(serializer.outwardCommonSyncMsg);
@@ -67,7 +83,7 @@ public:
 		 * The listener may choose to ignore it if they lack power.
 		 * But we must send this workSync because it carries sync.
 		 */
-		log(LogMessage::SendWorkSync);
+		trace(LogMessage::SendWorkSync);
 		DeltaTime forwardOffset = clique.schedule.deltaNowToNextSyncPoint();
 		serializer.outwardCommonSyncMsg.makeWorkSync(
 				forwardOffset,
@@ -76,7 +92,7 @@ public:
 				 * even if self is not the Master I.E. WorkSync could be from a Slave.
 				 */
 				clique.getMasterID(),
-				workOutMailbox->fetch());	// from app, outward
+				InputRecorder::work(workOutMailbox->fetch()));	// from app, outward
 		sendPrefabricatedMessage();
 	}
 
@@ -87,6 +103,15 @@ public:
 	 */
 	static void sendPrefabricatedMessage() {
 		// assert sender has created message in outwardCommonSyncMsg
+		// Every sync self sends is at self's distance from master (zero if self is master or not mesh)
+		serializer.outwardCommonSyncMsg.hopCount = clique.hopCount();
+		/*
+		 * And on self's clique's channel, where members listen.
+		 * MergeSync too: cliqueMerger names self's clique (merging other) or the clique self joined (merging my clique.)
+		 */
+		serializer.outwardCommonSyncMsg.channel = clique.channel();
+		// So receivers know path loss (not just how loud self is)
+		serializer.outwardCommonSyncMsg.xmitPower = network.xmitPowerDBm();
 		serializer.serializeOutwardCommonSyncMessage();
 		assert(serializer.bufferIsSane());
 		radio->transmitStaticSynchronously();
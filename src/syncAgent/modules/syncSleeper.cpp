@@ -6,11 +6,33 @@
 
 #include "../scheduleParameters.h"
 #include "../logMessage.h"
+#include "inputRecorder.h"
 
 namespace {
 Sleeper sleeper;
 LongClockTimer* longClockTimer;	// for toa
 
+/*
+ * Longest segment of a sleep programmed into platform's timer.
+ * Platform RTC compares only OSClockCountBits: a compare more than half its range ahead is ambiguous.
+ * Longer sleeps (long sync periods) chain segments.
+ */
+const DeltaTime MaxSleepSegment = MaxDeltaTime / 2;
+
+static_assert(ScheduleParameters::MaxSaneTimeout < MaxDeltaTime,
+		"Sync period too long for TimeMath on platform's OSClock, see SYNC_AGENT_DUTY_CYCLE_INVERSE.");
+
+/*
+ * Arm timer for deadline, or for end of a segment if deadline is beyond one segment.
+ * Returns true if armed for the deadline itself, i.e. final segment.
+ */
+bool armSegmentToward(LongTime deadline) {
+	LongTime segmentEnd = InputRecorder::clock(longClockTimer->nowTime()) + MaxSleepSegment;
+	bool isFinalSegment = deadline <= segmentEnd;
+	sleeper.setDeadline(isFinalSegment ? deadline : segmentEnd);
+	return isFinalSegment;
+}
+
 // Responsibility: statistics of invalid messages
 
 static uint32_t countValidReceives;
@@ -29,11 +51,12 @@ bool dispatchFilteredMsg( DispatchFuncPtr msgDispatcher) { // Slot has handlers
 	bool didReceiveDesiredMsg = false;
 
 	// Nested checks: physical layer CRC, then transport layer MessageType
-	if (radio->isPacketCRCValid()) {
+	if (InputRecorder::flag(InputRecorder::CRCValid, radio->isPacketCRCValid())) {
 		SyncMessage* msg = serializer.unserialize();
 		if (msg != nullptr) {
 			// assert msg->type valid
 			countValidReceives++;
+			linkQualityTable.heard(msg->masterID, InputRecorder::signalStrength(radio->receivedSignalStrength()));
 
 			//ledLogger2.toggleLED(3);	// debug: LED 3 valid received
 
@@ -57,7 +80,7 @@ bool dispatchFilteredMsg( DispatchFuncPtr msgDispatcher) { // Slot has handlers
 		}
 		else {
 			// Ignore garbled type or offset
-			log(">>>>Message garbled\n");
+			trace(LogMessage::Garbled);
 			countInvalidTypeReceives++;
 			//ledLogger2.toggleLED(4);	// debug: LED 4 invalid MessageType received
 			// continuation is sleep
@@ -72,7 +95,7 @@ bool dispatchFilteredMsg( DispatchFuncPtr msgDispatcher) { // Slot has handlers
 		 */
 
 		countInvalidCRCReceives++;
-		log(">>>>CRC\n");
+		trace(LogMessage::BadCRC);
 		//ledLogger2.toggleLED(4);	// debug: LED 4 invalid CRC received
 		// continuation is sleep
 	}
@@ -86,7 +109,8 @@ void SyncSleeper::init(
 		OSTime maxSaneTimeout,
 		LongClockTimer * aLCT)
 {
-	sleeper.init(maxSaneTimeout, aLCT);
+	// Platform only sees segments
+	sleeper.init((maxSaneTimeout < MaxSleepSegment) ? maxSaneTimeout : MaxSleepSegment, aLCT);
 	longClockTimer = aLCT;
 }
 
@@ -94,42 +118,40 @@ void SyncSleeper::clearReasonForWake() { sleeper.clearReasonForWake(); }
 
 
 /*
- * Sleep until timeout, ensuring that timeout time has elapsed:
+ * Sleep until deadline, ensuring that deadline has passed:
  * - ignoring any unexpected events
  *
+ * - chaining segments when deadline is beyond what platform's timer can schedule
+ *
  * Receiver is off, so no messages can be received.
  */
-void SyncSleeper::sleepUntilTimeout(OSTime (*timeoutFunc)()) {
-	while (true) {
-		// Calculate remaining timeout on each loop iteration
-		OSTime timeout = timeoutFunc();
-
-		assert(timeout < ScheduleParameters::MaxSaneTimeout);
+void SyncSleeper::sleepUntil(LongTime deadline) {
+	// Sane: not more than max timeout in future (past is OK, expires immediately.)
+	assert(TimeMath::clampedTimeDifferenceFromNow(deadline) < ScheduleParameters::MaxSaneTimeout);
 
-		sleeper.sleepUntilEventWithTimeout(timeout);
-		// wakened by msg or timeout or unexpected event
-		if ( sleeper.getReasonForWake() == TimerExpired)
-			// assert time specified by timeoutFunc has elapsed.
-			break;	// while true
-		else {
-			// reasonForWake is not TimerExpired, e.g. an unexpected reason
-			// continue next loop iteration
+	// Armed once (per segment)
+	bool isFinalSegment = armSegmentToward(deadline);
+	while (true) {
+		sleeper.sleepUntilEvent();
+		// wakened by timeout or unexpected event
+		if ( InputRecorder::wake(sleeper.getReasonForWake()) == TimerExpired) {
+			if (isFinalSegment)
+				// assert deadline has passed.
+				break;	// while true
+			isFinalSegment = armSegmentToward(deadline);
 		}
-		/*
-		 * timeoutFunc is monotonic and will eventually return 0
-		 * and sleeper.sleepUntilTimeout will return without sleeping and with reasonForWake==Timeout
-		 */
+		// else unexpected reason, deadline still armed, sleep again
 	}
-	// assert timeout amount of time has elapsed
+	// assert deadline has passed
 }
 
 
 /*
- * Sleep until timeout with radio on.
+ * Sleep until deadline with radio on.
  * Wake from sleep to dispatch messsages received.
  *
- * timeoutFunc gives remaining duration at time of call
- * (duration is known only to caller, but is generally fixed.)
+ * deadlineFunc gives deadline from schedule.
+ * Evaluated at start, and again only if a dispatched message changed schedule.
  * dispatchQueuedMsg dispatches message on queue
  *
  * On dispatchQueuedMsg() returns true (finds a desired message type),
@@ -138,17 +160,17 @@ void SyncSleeper::sleepUntilTimeout(OSTime (*timeoutFunc)()) {
  * Kind of desired message is different for each dispatcher,
  * and might also depend on a message and state?
  *
- * Returns no earlier than time of call plus duration.
+ * Returns no earlier than deadline (unless desired message.)
  * Might return slightly later if msg dispatch takes too long.
  *
  * Ensure message queue is nearly empty on return.
  * Could be a race to empty message queue.
  */
 
-bool SyncSleeper::sleepUntilMsgAcceptedOrTimeout(
+bool SyncSleeper::sleepUntilMsgAcceptedOrDeadline(
 		//Slot * msgHandlingSlot,
 		DispatchFuncPtr msgDispatcher,
-		OSTime (*timeoutFunc)())	// function returning remaining duration of slot
+		DeadlineFuncPtr deadlineFunc)	// function returning end of slot
 {
 	bool didReceiveDesiredMsg = false;
 	bool didTimeout = false;
@@ -167,27 +189,38 @@ bool SyncSleeper::sleepUntilMsgAcceptedOrTimeout(
 	//assert(sleeper.reasonForWakeIsCleared());	// This also checks we haven't received yet
 	// FUTURE currently, this is being cleared in sleepUntil but that suffers from races
 
+	uint32_t scheduleChanges = clique.schedule.countChanges();
+	LongTime deadline = deadlineFunc();
+	bool isFinalSegment = armSegmentToward(deadline);
+
 	while (true) {
 
-		/*
-		 * The design depends on Timer semantics: can a Timer be restarted?
-		 * Here, we assume not, and always that Timer was canceled.
-		 */
-		sleeper.sleepUntilEventWithTimeout(timeoutFunc());
+		// Deadline remains armed across wakes
+		sleeper.sleepUntilEvent();
 		// wakened by msg or timeout or unexpected event
 
-		sleeper.cancelTimeout();
-
-		switch (sleeper.getReasonForWake()) {
+		switch (InputRecorder::wake(sleeper.getReasonForWake())) {
 		case MsgReceived:
 			// Record TOA as soon as possible
 			clique.schedule.recordMsgArrivalTime();
 
-			// if timer semantics are: restartable, cancel timer here
 			didReceiveDesiredMsg = dispatchFilteredMsg(msgDispatcher);
+
+			// Rearm only if deadline might have moved
+			if (!didReceiveDesiredMsg && clique.schedule.countChanges() != scheduleChanges) {
+				scheduleChanges = clique.schedule.countChanges();
+				deadline = deadlineFunc();
+				sleeper.cancelTimeout();
+				isFinalSegment = armSegmentToward(deadline);
+			}
 			break;	// switch
 
 		case TimerExpired:
+			if (!isFinalSegment) {
+				// Only a segment of a long sleep expired: keep receiving
+				isFinalSegment = armSegmentToward(deadline);
+				break;	// switch
+			}
 			// Timeout could be interrupting a receive.
 			// Better to handle message and delay next slot: fewer missed syncs.
 
@@ -209,16 +242,13 @@ bool SyncSleeper::sleepUntilMsgAcceptedOrTimeout(
 			// assert(false);
 
 			// For now the solution is: continue in loop and sleep again.
-			// assert the timeoutFunc() will eventually return zero and not sleep with reason==TimerExpired
+			// assert deadline still armed, will expire with reason==TimerExpired
 			log("Unexpected wake, resume sleep.\n")
 			;
 		}
-		// If Timer semantics are restartable: timer might be canceled, but sleepUntilEventWithTimeout will restart it
-
 		if (didReceiveDesiredMsg || didTimeout) {
-			/*
-			 * assert radio off and timer cancelled.
-			 */
+			// Timer expired, or deadline no longer wanted
+			sleeper.cancelTimeout();
 			break;	// while(true)
 		}
 		// else continue while(true)
@@ -10,7 +10,16 @@
  * - filter invalid message packets received
  *
  * A main concern is that the platform Sleeper may wake unexpectedly on events.
- * This code guarantees that timeout has elapsed, even in face of unexpected wake.
+ * This code guarantees that deadline has passed, even in face of unexpected wake.
+ *
+ * Deadlines are absolute times (LongTime) programmed once into the platform's timer.
+ * An unexpected wake just sleeps again: no recalculation, timer still armed.
+ * While receiving, a dispatched message may change the schedule (see Schedule::countChanges()):
+ * only then is the deadline recalculated and timer rearmed.
+ * Keeps the path from wake to sleep short: it runs after every received packet.
+ *
+ * A deadline farther than the platform's timer can schedule (long sync periods)
+ * is reached by a chain of segments, transparent to callers.
  */
 
 
@@ -18,6 +27,9 @@ typedef void (*voidFuncPtr)();
 
 typedef bool (*DispatchFuncPtr)(SyncMessage *);
 
+// Function of schedule yielding absolute time, e.g. SyncSlotSchedule::timeOfThisSyncSlotEnd
+typedef LongTime (*DeadlineFuncPtr)();
+
 
 class SyncSleeper {
 
@@ -28,11 +40,12 @@ public:
 
 	static void clearReasonForWake();
 
-	static void sleepUntilTimeout(OSTime (*func)());
+	// Radio off: schedule can't change while sleeping, deadline is a value
+	static void sleepUntil(LongTime deadline);
 
-	static bool sleepUntilMsgAcceptedOrTimeout(
+	static bool sleepUntilMsgAcceptedOrDeadline(
 			DispatchFuncPtr,	// Slot*,
-			OSTime (*func)());
+			DeadlineFuncPtr);
 
 	static voidFuncPtr getMsgReceivedCallback();
 };
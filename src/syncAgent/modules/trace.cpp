@@ -0,0 +1,31 @@
+
+#include <nRF5x.h>	// LongClockTimer
+
+#include "trace.h"
+#include "inputRecorder.h"
+
+static_assert(sizeof(TraceRecord) == 12, "Trace record layout must match decoder.");
+static_assert((TraceBuffer::CountRecords & (TraceBuffer::CountRecords - 1)) == 0, "CountRecords power of two.");
+
+
+TraceBuffer traceBuffer = { TraceBuffer::Magic, 0, {} };
+
+
+void Trace::record(uint8_t event, uint32_t arg) {
+	TraceRecord* record = &traceBuffer.records[traceBuffer.countRecorded & (TraceBuffer::CountRecords - 1)];
+	// Not InputRecorder::nowTime(): a recorded clock reading per trace would make recording depend on trace level
+	record->time = (uint32_t) InputRecorder::timestamp();
+	record->arg = arg;
+	record->event = event;
+	traceBuffer.countRecorded++;
+
+	// Decisions to check a replay against
+	InputRecorder::decision(event, arg);
+}
+
+void Trace::clear() {
+	traceBuffer.magic = TraceBuffer::Magic;
+	traceBuffer.countRecorded = 0;
+	for (uint16_t i = 0; i < TraceBuffer::CountRecords; i++)
+		traceBuffer.records[i].event = 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <inttypes.h>
+
+
+/*
+ * Binary trace: ring of fixed size records (timestamp, event, arg.)
+ *
+ * Replaces formatted logging on the hot path: recording costs a clock read and a few stores.
+ * Events are LogMessage::Event, filtered at compile time by level (see trace() in logMessage.h.)
+ *
+ * Read off-target: debugger dumps traceBuffer (e.g. gdb "dump binary value trace.bin traceBuffer"),
+ * tools/traceDecoder prints it.
+ * Layout is fixed width little-endian (the target's), no padding: decoder depends on it.
+ */
+
+struct TraceRecord {
+	uint32_t time;	// LSB of LongClock (recording inputs: of last clock reading, see InputRecorder::timestamp)
+	uint32_t arg;
+	uint8_t event;	// LogMessage::Event
+	uint8_t reserved[3];
+};
+
+struct TraceBuffer {
+	static const uint32_t Magic = 0x54524345;	// "TRCE"
+	static const uint16_t CountRecords = 64;	// Power of two
+
+	uint32_t magic;
+	uint32_t countRecorded;	// Monotonic, next record at countRecorded % CountRecords
+	TraceRecord records[CountRecords];
+};
+
+// Not in anonymous namespace: debugger finds it by name
+extern TraceBuffer traceBuffer;
+
+
+class Trace {
+public:
+	static void record(uint8_t event, uint32_t arg);
+	static void clear();
+};
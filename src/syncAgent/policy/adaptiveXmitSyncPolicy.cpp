@@ -2,6 +2,7 @@
 #include <nRF5x.h>  // logger
 
 #include "adaptiveXmitSyncPolicy.h"
+#include "policyParameters.h"
 #include "../../augment/random.h"
 
 
@@ -11,16 +12,37 @@ namespace {
 MasterXmitSyncPolicy wrappedXmitSyncPolicy;
 static bool isAdvancedStage = false;
 
+// Sync periods since last merge activity, saturating
+ScheduleCount countQuietPeriods = 0;
+
+ScheduleCount adaptedPeriod() {
+	ScheduleCount result = Policy::MinCountSyncPeriodsToChooseMasterSyncXmits
+			+ countQuietPeriods / Policy::CountQuietSyncPeriodsPerStretch;
+	if (result > Policy::MaxCountSyncPeriodsToChooseMasterSyncXmits)
+		result = Policy::MaxCountSyncPeriodsToChooseMasterSyncXmits;
+	return result;
+}
+
+// Called once per sync period (while master)
+void tickActivity() {
+	if (countQuietPeriods < MaximumScheduleCount)
+		countQuietPeriods++;
+	wrappedXmitSyncPolicy.setPeriod(adaptedPeriod());
+}
+
 } // namespace
 
 
 void AdaptiveXmitSyncPolicy::reset() {
 	wrappedXmitSyncPolicy.reset();
 	isAdvancedStage = false;
+	countQuietPeriods = 0;
 }
 
 // Called every sync slot
 bool AdaptiveXmitSyncPolicy::shouldXmitSync() {
+	tickActivity();
+
 	if (isAdvancedStage )
 		// xmit sync according to wrapped policy (which is more random, and less frequently.)
 		return wrappedXmitSyncPolicy.shouldXmitSync();
@@ -37,6 +59,13 @@ void AdaptiveXmitSyncPolicy::advanceStage() {
 	isAdvancedStage = true;
 }
 
+void AdaptiveXmitSyncPolicy::onMergeActivity() {
+	countQuietPeriods = 0;
+	// Take effect now, not after a long current cycle
+	wrappedXmitSyncPolicy.setPeriod(adaptedPeriod());
+	wrappedXmitSyncPolicy.reset();
+}
+
 void AdaptiveXmitSyncPolicy::disarmForOneCycle() {
 	log("disarm xmit policy\n");
 	wrappedXmitSyncPolicy.disarmForOneCycle();
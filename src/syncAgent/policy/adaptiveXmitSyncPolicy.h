@@ -15,6 +15,11 @@
  * After join another clique, or hear work from another clique, advances to joined stage.
  * In joined stage, xmits sync less often.
  *
+ * In joined stage, frequency varies continuously (see Policy):
+ * - more often while merges are happening (clique changing membership or schedule)
+ * - less often the longer the clique is stable, up to the bound a slave's dropout allows.
+ * Master xmit is the largest energy cost of a unit, spend it only when needed.
+ *
  * The purpose is to accelerate achieving sync by a factor of 2 or more.
  * During startup (isolated stage) we xmit more often so there is more chance a fisher will hear us.
  *
@@ -45,6 +50,9 @@ public:
 
 	// Disarm the policy for one cycle, since we heard a sync, we don't need to xmit another in this cycle.
 	static void disarmForOneCycle();
+
+	// Clique is merging (or merged): xmit more often for a while.
+	static void onMergeActivity();
 };
 
 
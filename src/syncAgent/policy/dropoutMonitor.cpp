@@ -19,6 +19,12 @@ void DropoutMonitor::reset() { countSyncSlotsWithoutSyncMsg = 0; }
 
 void DropoutMonitor::heardSync() { reset(); }
 
+bool DropoutMonitor::isSyncOverdue() {
+	// Max span: last period of one choice of MasterSync period to first of the next
+	const ScheduleCount MaxSpan = 2 * Policy::MaxCountSyncPeriodsToChooseMasterSyncXmits - 1;
+	return countSyncSlotsWithoutSyncMsg > 0 && countSyncSlotsWithoutSyncMsg % MaxSpan == 0;
+}
+
 bool DropoutMonitor::isDropout(){
 	assert(countSyncSlotsWithoutSyncMsg <= Policy::maxMissingSyncsPerDropout);
 
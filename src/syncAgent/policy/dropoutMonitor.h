@@ -17,6 +17,12 @@ public:
 	static void heardSync();
 
 	static bool isDropout();
+
+	/*
+	 * After isDropout(): has a whole max span between MasterSyncs passed, again, without sync?
+	 * A master xmits at least once per span, so self missed one.
+	 */
+	static bool isSyncOverdue();
 };
 
 
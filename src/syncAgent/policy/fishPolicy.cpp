@@ -12,21 +12,21 @@ namespace {
  * But we don't fish it, since it delays start of SyncPeriod.
  */
 
-const ScheduleCount lastSlotToFish = ScheduleParameters::CountSlots - 1;	// !!!
-const ScheduleCount firstSlotToFish = ScheduleParameters::FirstSleepingSlotOrdinal;
+const SlotCount lastSlotToFish = ScheduleParameters::CountSlots - 1;	// !!!
+const SlotCount firstSlotToFish = ScheduleParameters::FirstSleepingSlotOrdinal;
 
 
 
-ScheduleCount simpleUpCounter = firstSlotToFish;
+SlotCount simpleUpCounter = firstSlotToFish;
 
-void incrementCounterModuloSleepingSlots(ScheduleCount* counter) {
+void incrementCounterModuloSleepingSlots(SlotCount* counter) {
 	(*counter)++;
 	if (*counter > lastSlotToFish) {
 		*counter = firstSlotToFish;
 	}
 }
 
-void decrementCounterModuloSleepingSlots(ScheduleCount* counter) {
+void decrementCounterModuloSleepingSlots(SlotCount* counter) {
 	(*counter)--;
 	if (*counter < firstSlotToFish) {
 		*counter = lastSlotToFish;
@@ -35,8 +35,8 @@ void decrementCounterModuloSleepingSlots(ScheduleCount* counter) {
 }
 
 
-ScheduleCount SimpleFishPolicy::nextFishSlotOrdinal() {
-	ScheduleCount result;
+SlotCount SimpleFishPolicy::nextFishSlotOrdinal() {
+	SlotCount result;
 
 	incrementCounterModuloSleepingSlots(&simpleUpCounter);
 	result = simpleUpCounter;
@@ -59,8 +59,8 @@ namespace {
  * !!! upCounter initialized to  last slot, the first call after reset increments,
  * and the first result is FirstSleepingSlotOrdinal.
  */
-	ScheduleCount upCounter = lastSlotToFish;
-	ScheduleCount downCounter = firstSlotToFish;
+	SlotCount upCounter = lastSlotToFish;
+	SlotCount downCounter = firstSlotToFish;
 	bool direction = true;
 }
 
@@ -73,8 +73,8 @@ void SyncRecoveryFishPolicy::reset() {
 	// next generated ordinal will be first sleeping slot
 }
 
-ScheduleCount SyncRecoveryFishPolicy::nextFishSlotOrdinal() {
-	ScheduleCount result;
+SlotCount SyncRecoveryFishPolicy::nextFishSlotOrdinal() {
+	SlotCount result;
 
 	if (direction) {
 		incrementCounterModuloSleepingSlots(&upCounter);
@@ -92,3 +92,22 @@ ScheduleCount SyncRecoveryFishPolicy::nextFishSlotOrdinal() {
 }
 
 
+void SyncRecoveryFishPolicy::saveState(State* state) {
+	state->upCounter = upCounter;
+	state->downCounter = downCounter;
+	state->direction = direction;
+}
+
+/*
+ * State is from a checkpoint that passed CRC, but might be from an older build with different CountSlots.
+ */
+void SyncRecoveryFishPolicy::restoreState(const State* state) {
+	if (state->upCounter < firstSlotToFish || state->upCounter > lastSlotToFish
+			|| state->downCounter < firstSlotToFish || state->downCounter > lastSlotToFish) {
+		reset();
+		return;
+	}
+	upCounter = state->upCounter;
+	downCounter = state->downCounter;
+	direction = state->direction;
+}
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <cassert>
-#include "../types.h"	// ScheduleCount
+#include "../types.h"	// SlotCount
 
 
 // FUTURE, resettable and a policy that fishes outward in both directions from sync slot.
@@ -33,7 +33,7 @@
  */
 class SimpleFishPolicy {
 public:
-	ScheduleCount nextFishSlotOrdinal();
+	SlotCount nextFishSlotOrdinal();
 	void reset() {}	// Does nothing, generator continues as before
 };
 
@@ -59,6 +59,18 @@ public:
  */
 class SyncRecoveryFishPolicy {
 public:
-	ScheduleCount nextFishSlotOrdinal();
+	SlotCount nextFishSlotOrdinal();
 	void reset();
+
+	/*
+	 * Fish history, saved across a reset by SyncCheckpoint.
+	 * Lets fishing continue fanning outward where it left off instead of starting over.
+	 */
+	struct State {
+		SlotCount upCounter;
+		SlotCount downCounter;
+		bool direction;
+	};
+	void saveState(State* state);
+	void restoreState(const State* state);
 };
@@ -19,6 +19,9 @@ public:
 	static void advanceStage() { }  // Nothing.  Policy has only one stage.
 
 	static void disarmForOneCycle() { clock.disarmForOneCycle(); }
+
+	// Count of sync periods in which to xmit once
+	static void setPeriod(ScheduleCount countSyncPeriods) { clock.setPeriod(countSyncPeriods); }
 };
 
 
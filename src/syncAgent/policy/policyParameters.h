@@ -43,4 +43,85 @@ public:
 	 * Gives too much contention.
 	 */
 	// static const ScheduleCount CountSyncPeriodsToChooseMasterSyncXmits = 1;
+
+	/*
+	 * AdaptiveXmitSyncPolicy varies the above in joined stage, between Min and Max.
+	 *
+	 * Min while merges are happening: new members need sync to converge.
+	 * Not 1: xmitting every period always contends with MergeSync intended for us.
+	 *
+	 * Max when clique is stable: slaves have heard many syncs, so their schedule is accurate.
+	 * Max span between MasterSyncs is twice this less one (last period of one choice, first of the next.)
+	 * A slave must survive one lost MasterSync (collision, or reduced xmit power):
+	 * two such spans must not exceed maxMissingSyncsPerDropout.  Hence a quarter of it.
+	 * Not larger while slaves xmit WorkSync (which also keeps sync and resets dropout):
+	 * a slave may hear no WorkSync (e.g. at the edge of the clique.)
+	 * Nor larger when slaves' drift estimate is good: dropout counts syncs missed, not drift.
+	 *
+	 * Stretch by one sync period per CountQuietSyncPeriodsPerStretch periods without merge activity.
+	 */
+	static const ScheduleCount MinCountSyncPeriodsToChooseMasterSyncXmits = 2;
+	static const ScheduleCount MaxCountSyncPeriodsToChooseMasterSyncXmits = maxMissingSyncsPerDropout / 4;
+	static const ScheduleCount CountQuietSyncPeriodsPerStretch = 32;
+
+	/*
+	 * XmitPowerPolicy.
+	 *
+	 * Margin: weakest member (greatest path loss) should hear self this strong.
+	 * nRF52 sensitivity is about -96 dBm (1Mbit), margin allows for fading, people moving etc.
+	 * Window: judge path loss of members over this many sync periods, so a member heard only by WorkSync counts.
+	 * Must be greater than twice the max MasterSync interval, so slaves hear master in every window.
+	 * Raise after this many consecutive sync periods without hearing any member:
+	 * at least the max span between MasterSyncs (twice MaxCountSyncPeriodsToChooseMasterSyncXmits)
+	 * but before dropout (maxMissingSyncsPerDropout.)
+	 * Step is that of the platform's levels.
+	 */
+	static const int8_t XmitPowerMarginRSSI = -80;
+	static const int8_t XmitPowerStepDB = 4;
+	static const ScheduleCount CountSyncPeriodsPerXmitPowerWindow = 48;
+	static const ScheduleCount MissedSyncsPerXmitPowerRaise = 32;
+
+	/*
+	 * LinkQualityTable: a link is reliable enough to follow its master when
+	 * packet success rate (scaled to 255) and RSSI are at least these.
+	 * A new link starts at 192.
+	 * Defer following a clique over an unreliable link at most this many times it is heard.
+	 * Its MasterSync comes every few sync periods: deferral lasts at most about a hundred periods.
+	 */
+	static const uint8_t MinReliableLinkRate = 160;
+	static const int8_t MinReliableLinkRSSI = -90;
+	static const uint8_t MaxDeferralsPerLink = 8;
+
+	/*
+	 * SyncCheckpoint saves state to retained memory once per this many SyncPeriods,
+	 * besides when syncing pauses for lack of power.
+	 * Retained memory may be flash: with 100k erase cycles, saving every half hour lasts years.
+	 */
+	static const ScheduleCount CountSyncPeriodsPerCheckpoint = 1024;
+
+	/*
+	 * Checkpoint older than this (in sync periods, about a day) is not resumed, SyncAgent starts fresh.
+	 *
+	 * Daily solar power down lasts less than a day.
+	 * Older checkpoint is from a unit that was stored or moved; its clique is probably gone.
+	 * Even a resumed schedule is only a guess of where to listen first; fishing finds the rest.
+	 */
+	static const uint32_t MaxCheckpointAgeSyncPeriods = 43200;
+
+	/*
+	 * Checkpoint younger than this (in sync periods) resumes fish history.
+	 * Beyond, drift uncertainty exceeds a slot: fan fishing outward afresh from the projected SyncPoint.
+	 */
+	static const ScheduleCount MaxCheckpointAgeToResumeFishing = maxMissingSyncsPerDropout;
 };
+
+
+// Slave survives one lost MasterSync at the longest interval (see MaxCountSyncPeriodsToChooseMasterSyncXmits)
+static_assert(2 * (2 * Policy::MaxCountSyncPeriodsToChooseMasterSyncXmits - 1) <= Policy::maxMissingSyncsPerDropout,
+		"MasterSync interval too long for dropout.");
+static_assert(Policy::MinCountSyncPeriodsToChooseMasterSyncXmits <= Policy::MaxCountSyncPeriodsToChooseMasterSyncXmits,
+		"MasterSync interval bounds.");
+// Xmit power raise (see XmitPowerPolicy) after max span between MasterSyncs, before dropout
+static_assert(Policy::MissedSyncsPerXmitPowerRaise >= 2 * Policy::MaxCountSyncPeriodsToChooseMasterSyncXmits
+		&& Policy::MissedSyncsPerXmitPowerRaise < Policy::maxMissingSyncsPerDropout,
+		"Xmit power raise between MasterSync span and dropout.");
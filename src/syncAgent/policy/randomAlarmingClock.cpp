@@ -21,9 +21,13 @@ bool isAlarmEnabled;
 ScheduleCount alarmTick;
 ScheduleCount clockTick;
 
+// Period of current cycle, and period of next cycles
+ScheduleCount period = Policy::CountSyncPeriodsToChooseMasterSyncXmits;
+ScheduleCount nextPeriod = Policy::CountSyncPeriodsToChooseMasterSyncXmits;
+
 void setAlarm() {
-	alarmTick = randUnsignedInt16(0, Policy::CountSyncPeriodsToChooseMasterSyncXmits-1);
-	// alarmTick in [0, CountSyncPeriodsToChooseMasterSyncXmits-1]
+	alarmTick = randUnsignedInt16(0, period-1);
+	// alarmTick in [0, period-1]
 }
 
 } // namespace
@@ -32,6 +36,7 @@ void setAlarm() {
 
 
 void RandomAlarmingCircularClock::wrap() {
+	period = nextPeriod;
 	clockTick = 0;
 	setAlarm();
 	isAlarmEnabled = true;
@@ -41,7 +46,7 @@ void RandomAlarmingCircularClock::wrap() {
 // Returns true if alarm goes off
 bool RandomAlarmingCircularClock::tickWithAlarm(){
 	// clockTick is unsigned => positive or zero
-	assert(clockTick <= Policy::CountSyncPeriodsToChooseMasterSyncXmits-1);
+	assert(clockTick <= period-1);
 
 	bool result;
 	if (isAlarmEnabled) {
@@ -54,7 +59,7 @@ bool RandomAlarmingCircularClock::tickWithAlarm(){
 	clockTick++;
 
 	// Make clock circular i.e. modulo
-	if (clockTick >= Policy::CountSyncPeriodsToChooseMasterSyncXmits)
+	if (clockTick >= period)
 		wrap();
 
 	return result;
@@ -66,5 +71,11 @@ void RandomAlarmingCircularClock::disarmForOneCycle() {
 }
 
 
+void RandomAlarmingCircularClock::setPeriod(ScheduleCount ticksPerPeriod) {
+	assert(ticksPerPeriod >= 1);
+	nextPeriod = ticksPerPeriod;
+}
+
+
 
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../types.h"	// ScheduleCount
+
 /*
  * Specialized RNG Random Number Generator
  *
@@ -10,6 +12,8 @@
  * tickWithAlarm() returns true once every TicksPerPeriod calls.
  * Thus duration between returns of true is at most 2*TicksPerPeriod.
  *
+ * TicksPerPeriod is variable (setPeriod), changes take effect at next wrap.
+ *
  * Metaphor: 24 hour clock with one hour hand
  * and one alarm hand that randomly changes by itself every midnight.
  * Unlike the usual clock, it is not self-powered: it ticks when you call tickWithAlarm().
@@ -37,4 +41,10 @@ public:
 	 * Alarm will reenable itself in next period.
 	 */
 	static void disarmForOneCycle();
+
+	/*
+	 * Change TicksPerPeriod, from next wrap.
+	 * Default is Policy::CountSyncPeriodsToChooseMasterSyncXmits
+	 */
+	static void setPeriod(ScheduleCount ticksPerPeriod);
 };
@@ -0,0 +1,112 @@
+
+#include <nRF5x.h>  // logger
+
+#include "xmitPowerPolicy.h"
+#include "policyParameters.h"
+
+
+namespace {
+
+/*
+ * Levels the radio supports, ascending, in dBm.
+ * nRF52 supports these (and -40, -30, +3 which we don't use.)
+ * Step between levels is Policy::XmitPowerStepDB
+ */
+const int8_t Levels[] = { -20, -16, -12, -8, -4, 0, 4 };
+const uint8_t CountLevels = sizeof(Levels) / sizeof(Levels[0]);
+const uint8_t FullPowerLevel = CountLevels - 1;
+
+uint8_t level = FullPowerLevel;
+
+// Window of sync periods
+ScheduleCount countPeriodsInWindow = 0;
+bool isHeardInWindow = false;
+// dB, greatest of members heard
+int16_t worstPathLossInWindow = 0;
+
+// Consecutive sync periods without hearing any member
+bool isHeardThisPeriod = false;
+ScheduleCount countPeriodsMissed = 0;
+
+
+void resetWindow() {
+	countPeriodsInWindow = 0;
+	isHeardInWindow = false;
+}
+
+void raise() {
+	if (level < FullPowerLevel) {
+		level++;
+		logInt(Levels[level]); log(" dBm xmit power raised\n");
+	}
+}
+
+void lower() {
+	if (level > 0) {
+		level--;
+		logInt(Levels[level]); log(" dBm xmit power lowered\n");
+	}
+}
+
+/*
+ * Judge RSSI at which the farthest member heard in window hears self at current power.
+ * Lower only if after lowering, it would still be above margin (hysteresis of one step.)
+ */
+void judgeWindow() {
+	int16_t weakestRSSI = Levels[level] - worstPathLossInWindow;
+	if (weakestRSSI < Policy::XmitPowerMarginRSSI)
+		raise();
+	else if (weakestRSSI >= Policy::XmitPowerMarginRSSI + Policy::XmitPowerStepDB)
+		lower();
+	// else just above margin: stay
+}
+
+} // namespace
+
+
+
+
+void XmitPowerPolicy::reset() {
+	level = FullPowerLevel;
+	resetWindow();
+	isHeardThisPeriod = false;
+	countPeriodsMissed = 0;
+}
+
+
+void XmitPowerPolicy::heardMember(int8_t xmitPower, int8_t rssi) {
+	isHeardThisPeriod = true;
+	int16_t pathLoss = (int16_t) xmitPower - rssi;
+	if (!isHeardInWindow || pathLoss > worstPathLossInWindow)
+		worstPathLossInWindow = pathLoss;
+	isHeardInWindow = true;
+}
+
+
+void XmitPowerPolicy::onSyncPeriodEnd() {
+	if (isHeardThisPeriod)
+		countPeriodsMissed = 0;
+	else
+		countPeriodsMissed++;
+	isHeardThisPeriod = false;
+
+	if (countPeriodsMissed >= Policy::MissedSyncsPerXmitPowerRaise) {
+		// Members may not be hearing self either.  Window is moot.
+		raise();
+		countPeriodsMissed = 0;
+		resetWindow();
+		return;
+	}
+
+	countPeriodsInWindow++;
+	if (countPeriodsInWindow >= Policy::CountSyncPeriodsPerXmitPowerWindow) {
+		if (isHeardInWindow)
+			judgeWindow();
+		resetWindow();
+	}
+}
+
+
+int8_t XmitPowerPolicy::dBm() { return Levels[level]; }
+
+int8_t XmitPowerPolicy::fullPowerDBm() { return Levels[FullPowerLevel]; }
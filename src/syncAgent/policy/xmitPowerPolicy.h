@@ -0,0 +1,41 @@
+#pragma once
+
+#include <inttypes.h>
+
+
+/*
+ * Chooses radio xmit power.
+ *
+ * A frame carries the power its sender xmitted at, so a receiver knows path loss: sender's power less RSSI.
+ * Path loss is reciprocal (same channel, same antennas), power is not:
+ * a member self hears with path loss L hears self at self's power less L.
+ *
+ * Lowers power (one step per window of sync periods)
+ * while the member of my clique with the greatest path loss during the window would still hear self
+ * comfortably above a margin.
+ * Raises power when it would hear self below the margin,
+ * or when sync periods pass without hearing any member (they might not be hearing self either.)
+ * Full power after reset, e.g. on master dropout.
+ *
+ * A Master that hears no WorkSync (quiet slaves) gets no feedback and stays at full power.
+ *
+ * Saves xmit energy, and reduces interference between co-located cliques.
+ * Not for MergeSync: it goes to another clique, not in the RSSI window, so it goes at full power (see Network.)
+ */
+class XmitPowerPolicy {
+public:
+	// Full power
+	static void reset();
+
+	// Heard sync from member of my clique, xmitted at given power, with given received signal strength
+	static void heardMember(int8_t xmitPower, int8_t rssi);
+
+	// Called once per sync period, after sync slot
+	static void onSyncPeriodEnd();
+
+	// Power to configure radio with
+	static int8_t dBm();
+
+	// Most the radio supports
+	static int8_t fullPowerDBm();
+};
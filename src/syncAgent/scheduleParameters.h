@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types.h"  // ScheduleCount, DeltaTime
+#include "../config.h"	// SYNC_AGENT_RELAY_MESH, SYNC_AGENT_DUTY_CYCLE_INVERSE
 
 
 /* !!! Parameters of schedule.
@@ -31,9 +32,9 @@
  * Thus there are some dead gaps: a short time at the beginning of the first fishing slot (when the radio is lagging)
  * and the tail end of the last virtual slot (which is not fished at all.)
  *
- * TODO a better design that doesn't have those gaps
- * e.g. that keeps the radio hot after the sync slot, when the second virtual slot (the first fish slot) is to be fished.
- * And some way of fishing closer to the sync point in the last virtual slot.
+ * When the first fish slot (or one nearly adjacent) is fished,
+ * CombinedSyncPeriod keeps the radio hot after the sync slot, so there is no gap there.
+ * TODO some way of fishing closer to the sync point in the last virtual slot.
  */
 
 
@@ -65,10 +66,12 @@ public:	// for assertions
  *
  * Lower limit: 1 = always on (one fish slot), 2 = 50% duty cycle.
  *outer
- * Upper limit: See types.h MaximumScheduleCount
- * Upper limit is constrained because this affects SyncPeriodDuration,
- * which cannot be longer than the duration
- * we can schedule on a Timer provided by OS and RTC hardware.
+ * Upper limit is constrained because this affects SyncPeriodDuration:
+ * - OTA offset field (see OTAPayload and SYNC_AGENT_WIDE_OFFSET)
+ * - TimeMath results, which must fit in platform's OSClock (MaxDeltaTime, 24 bits.)
+ * Sleeps longer than the platform Timer can schedule are chained by SyncSleeper.
+ *
+ * Configured in config.h, see SYNC_AGENT_DUTY_CYCLE_INVERSE.
  */
 // Production: 3 active slots, ~300 sleeping, ~3 second period
 // static const int           DutyCycleInverse = 100;
@@ -90,9 +93,10 @@ public:	// for assertions
 //static const DeltaTime     SlotDuration = 40;
 //static const unsigned int  DutyCycleInverse = 100;
 
-// 40, 800
+// 40, 800 Sync period 2 sec
+// 40, 12288 Sync period 30 sec
 static const DeltaTime     VirtualSlotDuration = 40;
-static const unsigned int  DutyCycleInverse = 800;
+static const SlotCount     DutyCycleInverse = SYNC_AGENT_DUTY_CYCLE_INVERSE;
 
 
 
@@ -113,8 +117,8 @@ static const DeltaTime     HalfSlotDuration = VirtualSlotDuration / 2;
  * When combined syncWorkSlot:
  * 1. SyncWork 2. Sleep, ...., Sleep
  */
-//static const ScheduleCount FirstSleepingSlotOrdinal = 3;
-static const ScheduleCount FirstSleepingSlotOrdinal = 2;
+//static const SlotCount FirstSleepingSlotOrdinal = 3;
+static const SlotCount FirstSleepingSlotOrdinal = 2;
 
 
 /*
@@ -123,17 +127,16 @@ static const ScheduleCount FirstSleepingSlotOrdinal = 2;
  * Average, since Fish slot is alternative to Merge slot,
  * which is a short transmit, probablistically transmitted within a SyncPeriod.
  */
-static const ScheduleCount CountActiveSlots = 2;
+static const SlotCount CountActiveSlots = 2;
 
 /*
  * Count of slots in sync period.
- * Must be less than MAX_UINT16 (256k)
  *
  * Used:
  * - to calculate SyncPeriodDuration
  * - to schedule Fish slots (this defines the max of the range.)
  */
-static const ScheduleCount CountSlots = CountActiveSlots*DutyCycleInverse;
+static const SlotCount CountSlots = CountActiveSlots*DutyCycleInverse;
 
 /*
  * Duration of 'normal' SyncPeriod in units ticks.
@@ -157,6 +160,7 @@ static const DeltaTime NormalSyncPeriodDuration = CountSlots * VirtualSlotDurati
 // 1 Mbit bitrate, 128bit message, 32kHz   yields .12mSec = 4 ticks
 // 2 Mbit bitrate, 128bit message, 32kHz   yields .064mSec == 64uSec = 2 ticks
 // 2 Mbit, 120 bits, 32kHz yields 1.8 ticks
+// Compact frame (SYNC_AGENT_COMPACT_OTA) 13 bytes, 104 bits, yields 1.6 ticks: still 2 at tick resolution
 static const DeltaTime MsgOverTheAirTimeInTicks = 2;
 
 /*
@@ -170,19 +174,16 @@ static const DeltaTime SenderLatency = 4;
 
 /*
  * After radio is powered on, delay until radio is enableable (DISABLED state).
- * This is one component of 'dead' time for radio.
+ * This was one component of 'dead' time for radio.
  *
  * Comprises:
  * - time for HFXO clock to stabilize (360uSec, 12 ticks)
  * - a few ticks for other overhead (some execution time.)
  * - an allowance for variance (expected worst deviation from experiments.)
  *
- * The constant is experimentally measured,
- * If enough allowance is not made,
- * there will be dead gaps in listening/fishing.
- * This is used to overlap real slots.
- *
- * !!! Should not be more than SlotDuration, else the last FishSlot will lap into SyncSlot
+ * Now only the initial lead of RadioPrewarm, which learns the actual delay
+ * and hides it by starting HFXO before each slot, while sleeping.
+ * So it is no longer dead time and no longer lengthens real slots.
  */
 static const DeltaTime PowerOffToActiveDelay = 16;
 
@@ -201,10 +202,12 @@ static const DeltaTime PowerOffToActiveDelay = 16;
 #endif
 
 /*
- * Delay from sleeping to radio ready (TXIDLE or RXIDLE).
+ * Delay from start of slot to radio ready (TXIDLE or RXIDLE).
  *
+ * Radio is prewarmed (see RadioPrewarm): HFXO is running and radio powered on at start of slot.
+ * Only the ramp up remains.
  */
-static const DeltaTime RadioLag = PowerOffToActiveDelay + RampupDelay;
+static const DeltaTime RadioLag = RampupDelay;
 
 /*
  * Real slots are greater duration than virtual slots.
@@ -223,8 +226,59 @@ static const DeltaTime RealSlotDuration = VirtualSlotDuration + RadioLag;
  */
 static const DeltaTime DeltaToSyncSlotMiddle = HalfSlotDuration + RadioLag - RampupDelay;
 
+/*
+ * Lateness of SyncPoint (see Schedule::rollPeriodForwardToNow.)
+ *
+ * Tolerance: lateness counted as late only beyond this (wake latency.)
+ * Max to perform slots: beyond this (into the period) the middle of the sync slot is past,
+ * where master xmits and slaves expect it, so the period's slots are skipped (sleeping till next SyncPoint.)
+ * Below it, late slots still work: sync offsets are calculated when sent, from the schedule, not from now.
+ */
+static const DeltaTime LateSyncPointTolerance = 2;
+static const DeltaTime MaxLatenessToPerformSlots = DeltaToSyncSlotMiddle;
+
+/*
+ * Listen before talk in middle of sync slot (see SyncWorkSlot.)
+ * Each backoff is random in [1, MaxBackoffDuration] ticks, after a CCA.
+ * Worst case delays xmit MaxBackoffDelay past middle: within the slot's second half, and before relays (see below.)
+ */
+static const DeltaTime ClearChannelAssessmentDuration = 4;	// About, including rx ramp up
+static const uint8_t MaxBackoffs = 2;
+static const uint16_t MaxBackoffDuration = 4;
+static const DeltaTime MaxBackoffDelay = MaxBackoffs * (ClearChannelAssessmentDuration + MaxBackoffDuration);
+
+static_assert(DeltaToSyncSlotMiddle + MaxBackoffDelay + RampupDelay + MsgOverTheAirTimeInTicks <= RealSlotDuration,
+		"Backed off sync must end within sync slot.");
 
 
-// Sanity.  SleepSync uses timeouts less than this, 5 seconds
-static const DeltaTime MaxSaneTimeout = 164000;
+
+/*
+ * Relay (SYNC_AGENT_RELAY_MESH.)
+ *
+ * Master's subslot starts at the middle of the sync slot, stretched by its worst case listen before talk.
+ * Slave at hop h relays in subslot h after it: at RelaySubslotsStart + (h-1) subslots after middle.
+ * Subslot comprises xmit ramp up, message on air, sender latency and switch back to receive.
+ * Hops beyond MaxRelayHops still join the clique but don't relay.
+ */
+static const uint8_t MaxRelayHops = 3;
+static const DeltaTime RelaySubslotDuration = RampupDelay + MsgOverTheAirTimeInTicks + SenderLatency + RampupDelay;
+static const DeltaTime RelaySubslotsStart = MaxBackoffDelay + RelaySubslotDuration;
+
+static_assert(MaxBackoffDelay + RampupDelay + MsgOverTheAirTimeInTicks + SenderLatency <= RelaySubslotsStart,
+		"Hop 1 relay must not collide with a backed off MasterSync or WorkSync.");
+
+#ifdef SYNC_AGENT_RELAY_MESH
+static const DeltaTime RelayExtension = MaxBackoffDelay + MaxRelayHops * RelaySubslotDuration;
+#else
+static const DeltaTime RelayExtension = 0;
+#endif
+
+
+
+/*
+ * Sanity.  SleepSync sleeps less than this.
+ * Longest sleep is a sync period extended by a merge, less than two normal periods.
+ * Was a constant 5 seconds, before sync periods could be long.
+ */
+static const DeltaTime MaxSaneTimeout = 2 * NormalSyncPeriodDuration;
 };
@@ -10,8 +10,12 @@
 
 namespace {
 
-// Remembered at start of fish slot
+// Chosen once per period, before sync slot
+SlotCount _ordinal;
+
+// Start of slot of _ordinal, against schedule when _memoCountChanges
 LongTime _memoStartTimeOfFishSlot;
+uint32_t _memoCountChanges;
 
 } // namespace
 
@@ -19,16 +23,35 @@ LongTime _memoStartTimeOfFishSlot;
 
 
 void FishSchedule::init() {
+	// policy chooses which normally sleeping slots to fish in.
+	_ordinal = fishPolicy.nextFishSlotOrdinal();
 	// Calculate the start once, memoize it
 	memoizeTimeOfThisFishSlotStart();
+
+	/*
+	 * Before sync slot, so before any adjustment this period.
+	 * Result must be less than timeOfNextSyncPoint,
+	 * else not enough time to perform a FishSlot without delaying end of SyncPeriod.
+	 */
+	assert(_memoStartTimeOfFishSlot < clique.schedule.timeOfNextSyncPoint() );
 }
 
-DeltaTime FishSchedule::deltaToSlotStart(){
-	return TimeMath::clampedTimeDifferenceFromNow(_memoStartTimeOfFishSlot);
+
+/*
+ * Same ordinal, against the changed schedule.
+ * A change shortening the period (see Schedule::adjustedEndTime) can put the slot past next SyncPoint:
+ * FishSlot then skips.
+ */
+void FishSchedule::refresh() {
+	if (clique.schedule.countChanges() != _memoCountChanges)
+		memoizeTimeOfThisFishSlotStart();
 }
 
-DeltaTime FishSchedule::deltaToSlotEnd(){
-	return TimeMath::clampedTimeDifferenceFromNow(timeOfThisFishSlotEnd());
+
+SlotCount FishSchedule::ordinal() { return _ordinal; }
+
+LongTime FishSchedule::timeOfThisFishSlotStart(){
+	return _memoStartTimeOfFishSlot;
 }
 
 
@@ -37,14 +60,12 @@ DeltaTime FishSchedule::deltaToSlotEnd(){
  * - starts at slot normally sleeping.
  * - Ends after remembered start.
  *
- * Start time is calculated once, at end of sync slot, in FishSchedule.init()
+ * Start time is calculated before sync slot, in FishSchedule.init(), and again if the schedule changed since.
  * Time til start is in [0, timeTilLastSleepingSlot]
  */
 void FishSchedule::memoizeTimeOfThisFishSlotStart() {
-	// policy chooses which normally sleeping slots to fish in.
-	ScheduleCount sleepingSlotOrdinal = fishPolicy.nextFishSlotOrdinal();
 	// minus 1: convert ordinal to zero-based duration multiplier
-	LongTime result = clique.schedule.startTimeOfSyncPeriod() +  (sleepingSlotOrdinal - 1) * ScheduleParameters::VirtualSlotDuration;
+	LongTime result = clique.schedule.startTimeOfSyncPeriod() +  (_ordinal - 1) * ScheduleParameters::VirtualSlotDuration;
 
 	/*
 	 * Since some cpu cycles have elapsed after end of previous slot,
@@ -65,14 +86,8 @@ void FishSchedule::memoizeTimeOfThisFishSlotStart() {
 	assert(result <= (nextSyncPoint - ScheduleParameters::SlotDuration + 10*ScheduleParameters::MsgDurationInTicks));
 #endif
 
-	/*
-	 * SyncPeriod is never shortened by adjustment.
-	 * Hence result must be less than timeOfNextSyncPoint,
-	 * else not enough time to perform a FishSlot without delaying end of SyncPeriod.
-	 */
-	assert(result < clique.schedule.timeOfNextSyncPoint() );
-
 	_memoStartTimeOfFishSlot = result;
+	_memoCountChanges = clique.schedule.countChanges();
 }
 
 LongTime FishSchedule::timeOfThisFishSlotEnd() {
@@ -88,6 +103,6 @@ LongTime FishSchedule::timeOfThisFishSlotEnd() {
 	}
 
 	// result may be < nowTime() i.e. in the past
-	// in which case delta==0 and sleepUntilTimeout(delta) will timeout immediately.
+	// in which case sleepUntil deadline will expire immediately.
 	return result;
 }
@@ -9,11 +9,14 @@
  */
 class FishSchedule {
 public:
+	// Choose slot (ordinal) for this period, before the sync slot
 	static void init();
+	// Place chosen slot again if schedule changed since (e.g. by sync in sync slot)
+	static void refresh();
 
-	static DeltaTime deltaToSlotStart();
-	static DeltaTime deltaToSlotEnd();
+	static SlotCount ordinal();
 
+	static LongTime timeOfThisFishSlotStart();
 	static LongTime timeOfThisFishSlotEnd();
 
 private:
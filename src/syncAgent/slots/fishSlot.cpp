@@ -13,6 +13,9 @@
 #include "fishSlot.h"
 #include "fishSchedule.h"
 #include "../logMessage.h"
+#include "../scheduleParameters.h"
+#include "../modules/channelPlan.h"
+#include "../modules/deadlineMonitor.h"
 
 
 namespace {
@@ -22,6 +25,16 @@ FishSchedule fishSchedule;
 
 
 bool doSyncMsg(SyncMessage* msg){
+	/*
+	 * Merging over an unreliable link (either way) would soon drop out again.
+	 * E.g. the former master self succeeded after dropout.  Keep fishing, a better link may turn up.
+	 * Only deferred: if fished again and again, merge anyway.
+	 */
+	if (linkQualityTable.shouldDefer(msg->masterID)) {
+		trace(LogMessage::FishedUnreliable, (uint32_t) msg->masterID);
+		return false;
+	}
+
 	/*
 	 * MasterSync may be better or worse.
 	 * toMergerRole() handles both cases,
@@ -42,7 +55,7 @@ bool doSyncMsg(SyncMessage* msg){
 
 void sleepUntilFishSlotStart() {
 	// pass function to sleeper
-	syncSleeper.sleepUntilTimeout(fishSchedule.deltaToSlotStart);
+	syncSleeper.sleepUntil(fishSchedule.timeOfThisFishSlotStart());
 }
 
 
@@ -54,7 +67,7 @@ void sleepUntilFishSlotStart() {
  * Intended catch: MasterSync from another clique's Master in its sync slot.
  */
 bool FishSlot::doMasterSyncMsg(SyncMessage* msg){
-	log(LogMessage::FishedMasterSync);
+	trace(LogMessage::FishedMasterSync);
 	return doSyncMsg(msg); }
 
 
@@ -64,7 +77,7 @@ bool FishSlot::doMasterSyncMsg(SyncMessage* msg){
  * Ignore except to stop fishing this slot.
  */
 bool FishSlot::doMergeSyncMsg(SyncMessage* msg){
-	log(LogMessage::FishedMergeSync);
+	trace(LogMessage::FishedMergeSync);
 	(void) msg; return true; }
 
 /*
@@ -77,7 +90,7 @@ bool FishSlot::doMergeSyncMsg(SyncMessage* msg){
  * can calculate the other clique's sync slot from the Work msg.
  */
 bool FishSlot::doWorkMsg(SyncMessage* msg) {
-	log(LogMessage::FishedWorkSync);
+	trace(LogMessage::FishedWorkSync);
 	return doSyncMsg(msg);
 }
 
@@ -116,23 +129,23 @@ bool FishSlot::dispatchMsgReceived(SyncMessage* msg){
 
 	switch(msg->type) {
 	case MasterSync:
-		log(LogMessage::RXMasterSync);
+		trace(LogMessage::RXMasterSync);
 		foundDesiredMessage = doMasterSyncMsg(msg);
 		break;
 	case MergeSync:
-		log(LogMessage::RXMergeSync);
+		trace(LogMessage::RXMergeSync);
 		foundDesiredMessage = doMergeSyncMsg(msg);
 		break;
 	case AbandonMastership:
-		log(LogMessage::RXAbandonMastership);
+		trace(LogMessage::RXAbandonMastership);
 		foundDesiredMessage = doAbandonMastershipMsg(msg);
 		break;
 	case WorkSync:
-		log(LogMessage::RXWorkSync);
+		trace(LogMessage::RXWorkSync);
 		foundDesiredMessage = doWorkMsg(msg);
 		break;
 	default:
-		log(LogMessage::RXUnknown);
+		trace(LogMessage::RXUnknown);
 	}
 
 	return foundDesiredMessage;
@@ -140,30 +153,95 @@ bool FishSlot::dispatchMsgReceived(SyncMessage* msg){
 
 
 
+void FishSlot::prepare() {
+	fishSchedule.init();	// Choose ordinal once
+	ChannelPlan::advanceFishing(fishSchedule.ordinal());
+}
+
+
+/*
+ * Is the gap between sync slot and this fish slot too short to be worth powering radio off?
+ * Restarting costs a crystal start (see RadioPrewarm) plus a ramp up.
+ * Listening through the gap costs about the same, and the gap is where drifted masters are likely to be.
+ *
+ * From the ordinal alone: both slots are placed from the same SyncPoint,
+ * so the gap doesn't change when the sync slot changes the schedule.
+ */
+bool FishSlot::isAdjacentToSyncSlot() {
+	DeltaTime fishStartFromSyncPoint = (fishSchedule.ordinal() - 1) * ScheduleParameters::VirtualSlotDuration;
+	DeltaTime syncEndFromSyncPoint = ScheduleParameters::RealSlotDuration + ScheduleParameters::RelayExtension;
+	return fishStartFromSyncPoint <= syncEndFromSyncPoint + radioPrewarm.lead() + ScheduleParameters::RampupDelay;
+}
+
+
+void FishSlot::placeAfterSyncSlot() {
+	fishSchedule.refresh();
+}
+
+
+LongTime FishSlot::timeOfSlotEnd() {
+	return fishSchedule.timeOfThisFishSlotEnd();
+}
+
+
 void FishSlot::perform() {
 	// FUTURE: A fish slot need not be aligned with other slots, and different duration???
 
 	// Sleep ultra low-power across normally sleeping slots to start of fish slot
 	assert(!radio->isPowerOn());
 
-	network.preamble();
+	// assert prepare() and placeAfterSyncSlot() called this period
+
+	// Period shortened (by sync in sync slot, see Schedule::adjustedEndTime) to before fish slot: skip this period
+	if (fishSchedule.timeOfThisFishSlotStart() >= clique.schedule.timeOfNextSyncPoint()) {
+		log("Fish past end, skip\n");
+		DeadlineMonitor::skip(DeadlineMonitor::FishSlotPhase);
+		return;
+	}
 
-	fishSchedule.init();	// Calculate start time once
+	// Not run HFXO while sleeping to fish slot, start it just in time
+	radioPrewarm.startBefore(fishSchedule.timeOfThisFishSlotStart());
 
 	sleepUntilFishSlotStart();
 
 	// logInt(Schedule::deltaPastSyncPointToNow()); log("fish tick\n");
 
-	network.prepareToTransmitOrReceive();
+	radioPrewarm.finish();
 	assert(radio->isPowerOn());
 
+	listenUntilCatchOrSlotEnd();
+}
+
+
+/*
+ * Alternative to perform(), when fish slot is adjacent to previous slot, which left radio on.
+ * One continuous receive session from end of previous slot to end of fish slot:
+ * no dead gap of crystal start and ramp up between the slots.
+ */
+void FishSlot::performContinuing() {
+	assert(radio->isPowerOn());
+	assert(radio->isDisabledState());
+	listenUntilCatchOrSlotEnd();
+}
+
+
+void FishSlot::listenUntilCatchOrSlotEnd() {
+	/*
+	 * Slot starts: after sleep, or at end of adjacent sync slot.
+	 * Deadline is end of slot as placed now: a catch moves the schedule, not the slot's obligation.
+	 */
+	LongTime deadline = fishSchedule.timeOfThisFishSlotEnd();
+	DeadlineMonitor::enter(DeadlineMonitor::FishSlotPhase);
+
+	// Radio is DISABLED: previous slot, if continuing, stopped receiving
+	network.setChannel(ChannelPlan::fishChannel());
 	network.startReceiving();
 	assert(!radio->isDisabledState());
 
 	// assert can receive an event that wakes imminently: race to sleep
-	syncSleeper.sleepUntilMsgAcceptedOrTimeout(
+	syncSleeper.sleepUntilMsgAcceptedOrDeadline(
 			dispatchMsgReceived, //this,
-			fishSchedule.deltaToSlotEnd);
+			fishSchedule.timeOfThisFishSlotEnd);
 	assert(radio->isDisabledState());
 	/*
 	 * Conditions:
@@ -180,6 +258,8 @@ void FishSlot::perform() {
 	network.shutdown();
 
 	network.postlude();
+
+	DeadlineMonitor::exit(DeadlineMonitor::FishSlotPhase, deadline);
 }
 
 
@@ -4,8 +4,19 @@
 
 
 class FishSlot{
+private:
+	static void listenUntilCatchOrSlotEnd();
+
 public:
+	// Choose slot to fish in.  Called before the sync slot, so SyncPeriod knows if the slots are adjacent.
+	static void prepare();
+	static bool isAdjacentToSyncSlot();
+	// After sync slot: place chosen slot against the schedule as the sync slot left it
+	static void placeAfterSyncSlot();
+
 	static void perform();
+	static void performContinuing();
+	static LongTime timeOfSlotEnd();
 	static bool dispatchMsgReceived(SyncMessage* msg);
 	static bool doMasterSyncMsg(SyncMessage* msg);
 	static bool doMergeSyncMsg(SyncMessage* msg);
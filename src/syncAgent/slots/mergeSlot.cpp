@@ -3,21 +3,20 @@
 
 #include "../globals.h"
 #include "mergeSlot.h"
+#include "../scheduleParameters.h"
+#include "../modules/deadlineMonitor.h"
 
 
 
 namespace {
 
 /*
- * Partial application:
- * Convert function of one arg into function of no args.
- *
- * A method that whenever called, returns time remaining until time to perform merge.
+ * Radio is prewarmed by this time, so xmit starts at merge start,
+ * with the same ramp up as the mergee master xmitting from its own sync slot.
  */
-DeltaTime timeoutUntilMerge() {
-	// TODO minor adjustment to account for ramp up of radio
-	return clique.schedule.deltaToThisMergeStart(
-			syncAgent.cliqueMerger.getOffsetToMergee());
+LongTime timeOfMerge() {
+	return clique.schedule.timeOfThisMergeStart(
+			syncAgent.cliqueMerger.getOffsetToMergee()->get());
 }
 
 } // namespace
@@ -27,6 +26,11 @@ DeltaTime timeoutUntilMerge() {
 // static data member
 MergePolicy MergeSlot::mergePolicy;
 
+// Xmit takes ramp up and time on air, within a slot
+LongTime MergeSlot::timeOfSlotEnd() {
+	return timeOfMerge() + ScheduleParameters::RealSlotDuration;
+}
+
 /*
  * Sleep all normally sleeping slots until time to xmit MergeSynce into mergee clique's SyncSlot.
  * !!! The time to xmit is not aligned with this schedule's slots, but with middle of mergee's SyncSlot.
@@ -34,13 +38,28 @@ MergePolicy MergeSlot::mergePolicy;
 void MergeSlot::perform() {
 	assert(!radio->isPowerOn());
 	assert(role.isMerger());
+
+	// Period shortened (by sync in sync slot) to before merge time: merge next period
+	if (timeOfMerge() <= clique.schedule.nowTime()) {
+		log("Merge past, skip\n");
+		DeadlineMonitor::skip(DeadlineMonitor::MergeSlotPhase);
+		return;
+	}
+
+	network.setChannel(syncAgent.cliqueMerger.getMergeeChannel());
+	// Mergee is another clique: maybe farther than self's weakest member
+	network.setFullXmitPower();
+	radioPrewarm.startBefore(timeOfMerge());
+
 	// Hard sleep without listening.
-	syncSleeper.sleepUntilTimeout(timeoutUntilMerge);
+	syncSleeper.sleepUntil(timeOfMerge());
 
-	network.preamble();
+	// Slot starts.  Deadline now: role may change below.
+	LongTime deadline = timeOfSlotEnd();
+	DeadlineMonitor::enter(DeadlineMonitor::MergeSlotPhase);
 
 	// assert time aligned with middle of a mergee sync slots (same wall time as fished sync from mergee.)
-	network.prepareToTransmitOrReceive();
+	radioPrewarm.finish();
 	logLongLong(clique.schedule.nowTime()); log(":mergeSync");
 	syncSender.sendMergeSync();
 	network.shutdown();
@@ -56,6 +75,8 @@ void MergeSlot::perform() {
 
 	network.postlude();
 
+	DeadlineMonitor::exit(DeadlineMonitor::MergeSlotPhase, deadline);
+
 	assert(!radio->isPowerOn());
 }
 
@@ -19,4 +19,5 @@ class MergeSlot {
 public:
 	static MergePolicy mergePolicy;	// visible to SyncAgent
 	static void perform();
+	static LongTime timeOfSlotEnd();	// Of this period's merge, when self is merger
 };
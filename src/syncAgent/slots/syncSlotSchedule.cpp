@@ -2,14 +2,19 @@
 #include "syncSlotSchedule.h"
 
 #include "../globals.h"  // clique, fishPolicy
+#include "../modules/clique.h"
 #include "../scheduleParameters.h"
 
-DeltaTime SyncSlotSchedule::deltaToThisSyncSlotMiddleSubslot(){
-	return TimeMath::clampedTimeDifferenceFromNow(timeOfThisSyncSlotMiddleSubslot());
-}
-
-DeltaTime SyncSlotSchedule::deltaToThisSyncSlotEnd(){
-	return TimeMath::clampedTimeDifferenceFromNow(timeOfThisSyncSlotEnd());
+/*
+ * Hop h relays in subslot h, after hearing hop h-1 in the preceding subslot.
+ * Master's subslot (hop 0) is longer: its xmit may be delayed by listen before talk.
+ */
+LongTime SyncSlotSchedule::timeOfThisRelaySubslot(){
+	// A slave is at least hop 1 (hop 0 only until its first sync from master sets hop)
+	uint8_t hop = (clique.hopCount() > 0) ? clique.hopCount() : 1;
+	return timeOfThisSyncSlotMiddleSubslot()
+			+ ScheduleParameters::RelaySubslotsStart
+			+ (hop - 1) * ScheduleParameters::RelaySubslotDuration;
 }
 
 /*
@@ -27,10 +32,12 @@ LongTime SyncSlotSchedule::timeOfThisSyncSlotMiddleSubslot() {
 
 /*
  * Real slot is longer than virtual slot,
- * by startup delays for radio.
+ * by startup delays for radio,
+ * and by relay subslots (if SYNC_AGENT_RELAY_MESH.)
  */
 LongTime SyncSlotSchedule::timeOfThisSyncSlotEnd() {
 	return clique.schedule.startTimeOfSyncPeriod()
-			+ ScheduleParameters::RealSlotDuration;		// !!!!
+			+ ScheduleParameters::RealSlotDuration		// !!!!
+			+ ScheduleParameters::RelayExtension;
 }
 
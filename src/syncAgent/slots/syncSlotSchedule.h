@@ -10,9 +10,9 @@ public:
 	 * We want the transmit to be in the middle of the subslot.
 	 * Since there is a ramp up delay, start the subslot before the middle of the SyncSlot.
 	 */
-	static DeltaTime deltaToThisSyncSlotMiddleSubslot();
-	static DeltaTime deltaToThisSyncSlotEnd();
-
 	static LongTime timeOfThisSyncSlotMiddleSubslot();
 	static LongTime timeOfThisSyncSlotEnd();	// Of this period
+
+	// Subslot in which self relays, by self's hop count
+	static LongTime timeOfThisRelaySubslot();
 };
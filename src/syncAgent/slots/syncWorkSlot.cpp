@@ -8,21 +8,56 @@
 #include "syncSlotSchedule.h"
 
 #include "../logMessage.h"
+#include "../modules/cliqueTag.h"
+#include "../modules/inputRecorder.h"
+#include "../scheduleParameters.h"
+#include "../../augment/random.h"
 
 
 namespace {
 
 SyncSlotSchedule slotSchedule;
 
+/*
+ * Heard sync that keeps self's sync in this slot (see SyncBehaviour::doSyncMsg.)
+ * Master: another member already synced the clique, needn't xmit.
+ * Slave: heard from upstream, has fresh sync to relay.
+ */
+bool heardSyncKeepingSync = false;
+
+/*
+ * Listen before talk: end of random backoff.
+ */
+LongTime _memoBackoffEnd;
+
+LongTime timeOfBackoffEnd() { return _memoBackoffEnd; }
+
+#ifdef SYNC_AGENT_RELAY_MESH
+/*
+ * Relay when heard fresh sync and not too far from master.
+ * Not when that sync moved self's SyncPoint later by more than the relay subslot's offset into the slot
+ * (self joined or was merged): relay subslot is still timed from the old start,
+ * and the offset from now would exceed a period.  Relay next period.
+ * Coin flip: peers at same hop would contend in the same subslot.
+ */
+bool shouldRelay() {
+	return heardSyncKeepingSync
+			&& !clique.isSelfMaster()
+			&& clique.hopCount() <= ScheduleParameters::MaxRelayHops
+			&& DeltaSync::isValidValue(clique.schedule.deltaNowToNextSyncPoint())
+			&& randBool();
+}
+#endif
+
 } // namespace
 
 
 
-bool SyncWorkSlot::doListenHalfSyncWorkSlot(OSTime (*timeoutFunc)()) {
+bool SyncWorkSlot::doListenHalfSyncWorkSlot(DeadlineFuncPtr deadlineFunc) {
 	network.startReceiving();
-	bool result = syncSleeper.sleepUntilMsgAcceptedOrTimeout(
+	bool result = syncSleeper.sleepUntilMsgAcceptedOrDeadline(
 			dispatchMsgReceived, //this,
-			timeoutFunc
+			deadlineFunc
 			);
 
 	// assert radio is on or off
@@ -36,7 +71,7 @@ bool SyncWorkSlot::doListenHalfSyncWorkSlot(OSTime (*timeoutFunc)()) {
 void SyncWorkSlot::doSendingWorkSyncWorkSlot(){
 	// not assert self is Master
 
-	(void) doListenHalfSyncWorkSlot(slotSchedule.deltaToThisSyncSlotMiddleSubslot);
+	(void) doListenHalfSyncWorkSlot(slotSchedule.timeOfThisSyncSlotMiddleSubslot);
 	assert(radio->isDisabledState());
 	assert(radio->isPowerOn());
 
@@ -49,8 +84,9 @@ void SyncWorkSlot::doSendingWorkSyncWorkSlot(){
 	 * - better clique (and self if Master might have relinquished mastership.)
 	 *
 	 * Even if my clique changed, need to send workSync to it.
+	 * Listen before talk, but send regardless (work is not dropped.)
 	 */
-
+	(void) isClearAfterBackoff();
 	syncSender.sendWorkSync();
 
 	/*
@@ -61,7 +97,7 @@ void SyncWorkSlot::doSendingWorkSyncWorkSlot(){
 	 *
 	 * Result doesn't matter, slot is over and we proceed regardless whether we heard sync keeping msg.
 	 */
-	(void) doListenHalfSyncWorkSlot(slotSchedule.deltaToThisSyncSlotEnd);
+	(void) doListenHalfSyncWorkSlot(slotSchedule.timeOfThisSyncSlotEnd);
 
 	// assert radio on or off
 }
@@ -80,18 +116,55 @@ void SyncWorkSlot::doSendingWorkSyncWorkSlot(){
 
 
 
+/*
+ * Listen before talk.
+ *
+ * Clear channel assessment; if busy, listen (not sleep) a random micro-backoff and try again.
+ * Returns true when channel is clear.
+ * Returns false if channel still busy after MaxBackoffs, or a sync keeping msg was heard during backoff.
+ *
+ * Backoff delays xmit a few ticks past the middle of the slot.
+ * Not need correction: sender calculates offset just as it sends (see SyncSender)
+ * and listeners calculate SyncPoint from time of arrival plus offset.
+ */
+bool SyncWorkSlot::isClearAfterBackoff() {
+	for (uint8_t backoff = 0; backoff < ScheduleParameters::MaxBackoffs; backoff++) {
+		if (InputRecorder::flag(InputRecorder::ChannelClear, radio->isChannelClear()))
+			return true;
+
+		log("Channel busy\n");
+		_memoBackoffEnd = clique.schedule.nowTime()
+				+ randUnsignedInt16(1, ScheduleParameters::MaxBackoffDuration);
+		(void) doListenHalfSyncWorkSlot(timeOfBackoffEnd);
+		assert(radio->isDisabledState());
+		if (heardSyncKeepingSync)
+			return false;
+	}
+	return false;
+}
+
+
+
 #ifdef NOTUSED
 // Sleep with radio off for remainder of sync slot
 void SyncWorkSlot::doIdleSlotRemainder() {
 	assert(!radio->isPowerOn());
-	syncSleeper.sleepUntilTimeout(clique.schedule.deltaToThisSyncSlotEnd);
+	syncSleeper.sleepUntil(slotSchedule.timeOfThisSyncSlotEnd());
 }
 #endif
 
 /*
  * listen for sync the whole period.
+ * Mesh: interrupted by relaying in own subslot.
  */
 void SyncWorkSlot::doSlaveSyncWorkSlot() {
+#ifdef SYNC_AGENT_RELAY_MESH
+	(void) doListenHalfSyncWorkSlot(slotSchedule.timeOfThisRelaySubslot);
+	if (shouldRelay())
+		syncSender.sendRelaySync();
+	// Result doesn't matter, keep listening for better masters and work
+	(void) doListenHalfSyncWorkSlot(slotSchedule.timeOfThisSyncSlotEnd);
+#else
 	network.startReceiving();
 	// This assertion is time sensitive, can't stay in production code
 	assert(!radio->isDisabledState()); // listening for other's sync
@@ -99,13 +172,14 @@ void SyncWorkSlot::doSlaveSyncWorkSlot() {
 	// Log delay from sync point to actual start listening.
 	// logInt(clique.schedule.deltaPastSyncPointToNow()); log("<delta SP to sync listen.\n");
 
-	(void) syncSleeper.sleepUntilMsgAcceptedOrTimeout(
+	(void) syncSleeper.sleepUntilMsgAcceptedOrDeadline(
 			dispatchMsgReceived, //this,
-			slotSchedule.deltaToThisSyncSlotEnd);
+			slotSchedule.timeOfThisSyncSlotEnd);
 	/*
 	 * Not using result:  all message handlers return false i.e. keep looking.
 	 * Assert we timed out and now is end of slot.
 	 */
+#endif
 }
 
 
@@ -115,9 +189,7 @@ void SyncWorkSlot::doSlaveSyncWorkSlot() {
  */
 void SyncWorkSlot::doMasterSyncWorkSlot() {
 
-	bool heardSyncKeepingSync;
-
-	heardSyncKeepingSync = doListenHalfSyncWorkSlot(slotSchedule.deltaToThisSyncSlotMiddleSubslot);
+	(void) doListenHalfSyncWorkSlot(slotSchedule.timeOfThisSyncSlotMiddleSubslot);
 	assert(radio->isDisabledState());
 
 	/*
@@ -125,15 +197,17 @@ void SyncWorkSlot::doMasterSyncWorkSlot() {
 	 * - a sync from a worse clique,
 	 * - OR a synch-keeping msg
 	 * Regardless, continue to listen, mainly for work.
+	 *
+	 * Self is Master, send sync if didn't hear WorkSync or MergeSync, and channel is clear.
+	 * If channel busy, probably a MergeSync intended for my clique: don't step on it.
 	 */
-	if (! heardSyncKeepingSync) {
-		// Self is Master, send sync if didn't hear WorkSync or MergeSync
+	if (! heardSyncKeepingSync && isClearAfterBackoff()) {
 		syncSender.sendMasterSync();
 	}
 
 	// Keep listening for other better Masters and work.
 	// Result doesn't matter, slot is over and we proceed whether we heard sync keeping sync or not.
-	(void) doListenHalfSyncWorkSlot(slotSchedule.deltaToThisSyncSlotEnd);
+	(void) doListenHalfSyncWorkSlot(slotSchedule.timeOfThisSyncSlotEnd);
 
 	// assert radio on or off
 }
@@ -154,12 +228,32 @@ void SyncWorkSlot::doMasterSyncWorkSlot() {
  */
 
 bool SyncWorkSlot::doMasterSyncMsg(SyncMessage* msg) {
-	(void) syncBehaviour.doSyncMsg(msg);
+	/*
+	 * Only a master xmits MasterSync, and self can't hear itself.
+	 * So MasterSync with self's masterID while self is master is from another master with same clique tag.
+ * (Unless relayed: hop count not zero.)
+	 * Never happens with full IDs.
+	 */
+	if (clique.isSelfMaster() && clique.isMsgFromMyClique(msg->masterID) && msg->hopCount == 0) {
+		if (CliqueTag::onCollision())
+			// Self now master of a clique with new tag.  Members will follow or drop out.
+			clique.setSelfMastership();
+		return false;
+	}
+
+	if (syncBehaviour.doSyncMsg(msg))
+		heardSyncKeepingSync = true;
 	return false;	// keep looking
 }
 
 bool SyncWorkSlot::doMergeSyncMsg(SyncMessage* msg) {
-	(void) syncBehaviour.doSyncMsg(msg);
+	/*
+	 * Like MasterSync: a MergeSync that moved self's schedule keeps sync.
+	 * Self (if it was master) must not also xmit MasterSync this slot:
+	 * its offset, from the moved schedule, can exceed a period.
+	 */
+	if (syncBehaviour.doSyncMsg(msg))
+		heardSyncKeepingSync = true;
 	return false;
 }
 
@@ -189,7 +283,8 @@ bool SyncWorkSlot::doWorkMsg(SyncMessage* msg){
 	/*
 	 *  Handle sync aspect of message.
 	 */
-	syncBehaviour.doSyncMsg(msg);
+	if (syncBehaviour.doSyncMsg(msg))
+		heardSyncKeepingSync = true;
 
 	return false;	// keep looking
 }
@@ -204,23 +299,23 @@ bool SyncWorkSlot::dispatchMsgReceived(SyncMessage* msg){
 
 	switch(msg->type) {
 	case MasterSync:
-		log(LogMessage::RXMasterSync);
+		trace(LogMessage::RXMasterSync);
 		foundDesiredMessage = doMasterSyncMsg(msg);
 		break;
 	case MergeSync:
-		log(LogMessage::RXMergeSync);
+		trace(LogMessage::RXMergeSync);
 		foundDesiredMessage = doMergeSyncMsg(msg);
 		break;
 	case AbandonMastership:
-		log(LogMessage::RXAbandonMastership);
+		trace(LogMessage::RXAbandonMastership);
 		foundDesiredMessage = doAbandonMastershipMsg(msg);
 		break;
 	case WorkSync:
-		log(LogMessage::RXWorkSync);
+		trace(LogMessage::RXWorkSync);
 		foundDesiredMessage = doWorkMsg(msg);
 		break;
 	default:
-		log(LogMessage::RXUnknown);
+		trace(LogMessage::RXUnknown);
 	}
 
 	return foundDesiredMessage;
@@ -236,12 +331,16 @@ bool SyncWorkSlot::dispatchMsgReceived(SyncMessage* msg){
  * !!! The offset must be half the slot length, back to start of SyncPeriod
  */
 
-void SyncWorkSlot::perform() {
+void SyncWorkSlot::performActive() {
 	// logInt(clique.schedule.deltaPastSyncPointToNow()); log("<delta SP to start slot.\n");
 
-	network.preamble();
+	heardSyncKeepingSync = false;
+
+	// Radio powers on (in finish) on my clique's channel
+	network.setChannel(clique.channel());
 
-	network.prepareToTransmitOrReceive();
+	// HFXO was started before SyncPoint, at end of previous period
+	radioPrewarm.finish();
 
 
 	// Call shouldTransmitSync every time, since it needs calls sideeffect reset itself
@@ -252,7 +351,7 @@ void SyncWorkSlot::perform() {
 	 * Work must be rare, lest it flood network and destroy sync
 	 * (colliding too often with MergeSync or MasterSync.)
 	 */
-	if (workOutMailbox->isMail() ) {
+	if (InputRecorder::flag(InputRecorder::Mail, workOutMailbox->isMail()) ) {
 		// This satisfies needXmitSync
 		doSendingWorkSyncWorkSlot();
 	}
@@ -274,16 +373,38 @@ void SyncWorkSlot::perform() {
 
 	// Radio is on or off.  If on, we timeout'd while receiving
 	network.stopReceiving();
-	// Radio on or off
-	// Turn radio off, workSlot may not need it on
-	network.shutdown();
 
 	// FUTURE we could do this elsewhere, e.g. start of sync slot so this doesn't delay the start of work slot
 	if (!clique.isSelfMaster())
 		clique.checkMasterDroppedOut();
 
+	xmitPowerPolicy.onSyncPeriodEnd();
+}
+
+
+LongTime SyncWorkSlot::timeOfSlotEnd() {
+	return slotSchedule.timeOfThisSyncSlotEnd();
+}
+
+
+void SyncWorkSlot::perform() {
+	performActive();
+
+	// Radio on or off
+	// Turn radio off, workSlot may not need it on
+	network.shutdown();
 	network.postlude();
 
 	assert(!radio->isPowerOn());	// ensure
 }
 
+
+/*
+ * Alternative to perform() when the next slot starts (almost) immediately.
+ * Radio and HFXO stay on: next slot is responsible for shutting them down.
+ */
+void SyncWorkSlot::performKeepingRadioOn() {
+	performActive();
+	// Radio is on, not receiving
+}
+
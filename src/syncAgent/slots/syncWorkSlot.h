@@ -37,7 +37,7 @@
 
 class SyncWorkSlot {
 private:
-	static bool doListenHalfSyncWorkSlot(OSTime (*timeoutFunc)());
+	static bool doListenHalfSyncWorkSlot(DeadlineFuncPtr deadlineFunc);
 
 	/*
 	 * Three behaviours of slot:
@@ -50,10 +50,14 @@ private:
 	static void doSendingWorkSyncWorkSlot();
 	static void doMasterSyncWorkSlot();
 	static void doSlaveSyncWorkSlot();
-	
+
+	static void performActive();
+	static bool isClearAfterBackoff();
 	
 public:
 	static void perform();
+	static void performKeepingRadioOn();
+	static LongTime timeOfSlotEnd();
 	static bool dispatchMsgReceived(SyncMessage* msg);	// Same code as for SyncWorkSlot
 	static bool doMasterSyncMsg(SyncMessage* msg);
 	static bool doMergeSyncMsg(SyncMessage* msg);
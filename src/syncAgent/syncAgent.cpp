@@ -3,10 +3,15 @@
 #include "syncAgent.h"
 #include "globals.h"	// which includes nRF5x.h
 #include "scheduleParameters.h"
+#include "modules/cliqueTag.h"
+#include "modules/deadlineMonitor.h"
+#include "modules/inputRecorder.h"
+#include "../augment/random.h"
 
 
 // Static data members
 bool SyncAgent::isSyncingState = false;
+bool SyncAgent::isResumingSchedule = false;
 // DYNAMIC uint8_t SyncAgent::receiveBuffer[255];
 
 CliqueMerger SyncAgent::cliqueMerger;
@@ -36,6 +41,16 @@ void SyncAgent::init(
 {
 	// require radio initialized
 
+	// Before any input is read
+	InputRecorder::start();
+
+	/*
+	 * Seed before any random choice (e.g. CliqueTag.)
+	 * Stream by ID: units never share a sequence, even if reset together.
+	 * Seed by clock: LongClock at init jitters (startup of LF crystal), varies sequence across resets of a unit.
+	 */
+	randSeed(InputRecorder::clock(aLCT->nowTime()), myID());
+
 	syncSleeper.init(
 			2* ScheduleParameters::NormalSyncPeriodDuration,
 			aLCT);
@@ -55,8 +70,15 @@ void SyncAgent::init(
 
 	// Serializer reads and writes directly to radio buffer
 	serializer.init(radio->getBufferAddress(), Radio::FixedPayloadCount);
+	linkQualityTable.reset();
+	DeadlineMonitor::reset();
 
-	clique.init();
+	/*
+	 * Resume clique from checkpoint (e.g. after daily solar power down), else fresh clique.
+	 */
+	isResumingSchedule = syncCheckpoint.restore();
+	if (!isResumingSchedule)
+		clique.init();
 	// Assert LongClock is reset and running
 
 	// radio device may be on from prior debugging w/o hard reset
@@ -64,7 +86,7 @@ void SyncAgent::init(
 
 	// ensure initial state of SyncAgent
 	assert(role.isFisher());
-	assert(clique.isSelfMaster());
+	assert(clique.isSelfMaster() || isResumingSchedule);
 	assert(!radio->isPowerOn());
 }
 
@@ -77,6 +99,9 @@ void SyncAgent::pauseSyncing() {
 
 	assert(!radio->isPowerOn());
 
+	// Probably browning out.  Remember clique and schedule in case mcu resets.
+	syncCheckpoint.save();
+
 	// FUTURE if clique is probably not empty
 	if (clique.isSelfMaster()) doDyingBreath();
 	// else I am a slave, just drop out of clique, others may have enough power
@@ -90,7 +115,7 @@ void SyncAgent::pauseSyncing() {
  * Might not be heard, in which case other units should detect DropOut.
  */
 void SyncAgent::doDyingBreath() {
-	serializer.outwardCommonSyncMsg.makeAbandonMastership(myID());
+	serializer.outwardCommonSyncMsg.makeAbandonMastership(CliqueTag::selfMasterID());
 	syncSender.sendPrefabricatedMessage();
 }
 
@@ -105,6 +130,8 @@ void SyncAgent::toMergerRole(SyncMessage* msg){
 	assert(role.isFisher());
 	role.setMerger();
 	cliqueMerger.initFromMsg(msg);
+	// Whether self is merging own clique or itself, clique will be changing
+	clique.onMergeActivity();
 
 	// assert my schedule might have been adjusted
 	// assert I might have relinquished mastership
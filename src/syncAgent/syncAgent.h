@@ -3,6 +3,7 @@
 
 #include "modules/message.h"
 #include "modules/cliqueMerger.h"
+#include "../config.h"	// SYNC_AGENT_RECORD_INPUTS
 
 
 
@@ -36,6 +37,8 @@ class SyncAgent {
 // Some of data members: see also anon namespaces for other owned objects
 private:
 	static bool isSyncingState;
+	// Clique and schedule resumed from checkpoint, first period is partial
+	static bool isResumingSchedule;
 	// DYNAMIC static uint8_t receiveBuffer[Radio::MaxMsgLength];
 	// FIXED: Radio owns fixed length buffer
 
@@ -64,6 +67,13 @@ public:
 			void (*onSyncPoint)()
 			);
 	static void loop() __attribute__ ((noreturn));
+#ifdef SYNC_AGENT_RECORD_INPUTS
+	/*
+	 * Replay only: alternative to loop(), after init().
+	 * Resumes state recorded at a restart of input recording (see SyncCheckpoint::resumeFromRestart.)
+	 */
+	static void loopFromRestart(const uint8_t* state, uint16_t count) __attribute__ ((noreturn));
+#endif
 
 	static void startSyncing();
 	static void doSyncPeriod();
@@ -76,6 +86,8 @@ public:
 	static void toFisherRole();
 
 private:
+	static void initLoop();
+	static void loopOnSyncPeriods() __attribute__ ((noreturn));
 	static void pauseSyncing();
 	static void doDyingBreath();
 };
@@ -6,6 +6,9 @@
 #include "syncAgent.h"
 
 #include "syncPeriod/syncPeriod.h"
+#include "modules/deadlineMonitor.h"
+#include "modules/inputRecorder.h"
+#include "scheduleParameters.h"
 
 
 
@@ -33,18 +36,24 @@ PowerManager powerManager;
 
 
 
-void SyncAgent::loop(){
-	// When first enter loop, each unit is master of its own clique
-	assert(clique.isSelfMaster());
-
+void SyncAgent::initLoop() {
 	ledLogger.init();	// DEBUG
 	initLogging();
+	Trace::clear();
 
 	log("ID:\n");
 	logLongLong(clique.getMasterID());
 
 	assert(! isSyncingState);
 	assert(!radio->isPowerOn());
+}
+
+
+void SyncAgent::loop(){
+	// When first enter loop, each unit is master of its own clique, unless resumed from checkpoint
+	assert(clique.isSelfMaster() || isResumingSchedule);
+
+	initLoop();
 
 	/*
 	 * assert schedule already started and not too much time has elapsed
@@ -53,13 +62,58 @@ void SyncAgent::loop(){
 	 * we need to initialize schedule differently.
 	 */
 
+	/*
+	 * Resumed schedule starts with a partial period, ending at the projected SyncPoint.
+	 * Sleep through it so the first sync slot is where the remembered sync slot should be.
+	 */
+	if (isResumingSchedule) {
+		radioPrewarm.startBefore(clique.schedule.timeOfNextSyncPoint());
+		syncSleeper.sleepUntil(clique.schedule.timeOfNextSyncPoint());
+		clique.schedule.rollPeriodForwardToNow();
+		isResumingSchedule = false;
+	}
+
+	loopOnSyncPeriods();
+}
+
+
+#ifdef SYNC_AGENT_RECORD_INPUTS
+void SyncAgent::loopFromRestart(const uint8_t* state, uint16_t count) {
+	initLoop();
+
+	// At SyncPoint: periods are whole, no partial first period
+	syncCheckpoint.resumeFromRestart(state, count);
+	isResumingSchedule = false;
+
+	loopOnSyncPeriods();
+}
+#endif
+
+
+void SyncAgent::loopOnSyncPeriods() {
 	while (true){
-		// call back app
+		// Judge lateness of roll before callback: a long callback only shortens self's sync slot
+		bool isLateForSlots = clique.schedule.isLateForSlots();
+
+		// call back app.  Its time cuts into sync slot: by middle, self misses its chance to xmit.
+		DeadlineMonitor::enter(DeadlineMonitor::SyncPointCallbackPhase);
 		onSyncPointCallback();
+		DeadlineMonitor::exit(DeadlineMonitor::SyncPointCallbackPhase,
+				clique.schedule.startTimeOfSyncPeriod() + ScheduleParameters::MaxLatenessToPerformSlots);
 
 		assert(!radio->isPowerOn());	// Radio is off after every sync period
 
-		if ( powerManager.isPowerForRadio() ) {
+		if (isLateForSlots) {
+			/*
+			 * Too late to perform this period's slots (rolled late.)
+			 * Skip them, keeping schedule: next period starts on time.
+			 */
+			log("Skip late period\n");
+			clique.schedule.countSkippedPeriod();
+			radioPrewarm.cancel();
+			syncSleeper.sleepUntil(clique.schedule.timeOfNextSyncPoint());
+		}
+		else if ( InputRecorder::flag(InputRecorder::PowerForRadio, powerManager.isPowerForRadio()) ) {
 			/*
 			 * Sync keeping: use radio
 			 */
@@ -71,14 +125,18 @@ void SyncAgent::loop(){
 			/*
 			 * Sync maintenance: don't use radio but keep schedule by sleeping one sync period.
 			 */
+			// HFXO may have been prewarmed for a sync slot we now skip
+			radioPrewarm.cancel();
 			if (isSyncingState) { pauseSyncing(); }
 			isSyncingState = false;
-			syncSleeper.sleepUntilTimeout(clique.schedule.deltaNowToNextSyncPoint);
+			syncSleeper.sleepUntil(clique.schedule.timeOfNextSyncPoint());
 			// sleep an entire sync period, then check power again.
 		}
 		// Sync period over, advance schedule.
 		// Keep schedule even if not enough power to xmit sync messages to maintain accuracy
 		clique.schedule.rollPeriodForwardToNow();
+
+		syncCheckpoint.periodicSave();
 	}
 	// never returns
 }
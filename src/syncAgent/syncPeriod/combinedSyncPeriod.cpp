@@ -7,6 +7,7 @@
 #include "../slots/syncWorkSlot.h"
 #include "../slots/fishSlot.h"
 #include "../slots/mergeSlot.h"
+#include "../modules/deadlineMonitor.h"
 
 namespace {
 SyncWorkSlot syncWorkSlot;
@@ -17,33 +18,73 @@ MergeSlot mergeSlot;
 
 /*
  * Each slot needs radio and radio requires HfCrystalClock.
- * Each slot is responsible for starting and stopping HfCrystalClock .
+ * Each slot is responsible for stopping HfCrystalClock.
+ * Starting is prewarmed: before the slot, while sleeping (see RadioPrewarm.)
+ * The sync slot of the next period is prewarmed at the end of this period.
  */
 void CombinedSyncPeriod::doSlotSequence() {
 
 	// Schedule.rollPeriodForward logs syncPoint
 
-	// first, arbitrary
-	syncWorkSlot.perform();
+	/*
+	 * Choose fish slot before sync slot.
+	 * Role does not change in sync slot (only fishing changes role to Merger.)
+	 */
+	DeadlineMonitor::enter(DeadlineMonitor::SlotSequencePhase);
 
+	bool isFishing = !role.isMerger();
+	if (isFishing)
+		fishSlot.prepare();
+
+	/*
+	 * Fish slot adjacent to sync slot: keep radio on from sync slot through fish slot.
+	 * Session ends on a catch or at end of fish slot.
+	 */
+	if (isFishing && fishSlot.isAdjacentToSyncSlot()) {
+		DeadlineMonitor::enter(DeadlineMonitor::SyncWorkSlotPhase);
+		syncWorkSlot.performKeepingRadioOn();
+		DeadlineMonitor::exit(DeadlineMonitor::SyncWorkSlotPhase, syncWorkSlot.timeOfSlotEnd());
+		fishSlot.placeAfterSyncSlot();
+		fishSlot.performContinuing();
+	}
+	else {
+		// first, arbitrary
+		DeadlineMonitor::enter(DeadlineMonitor::SyncWorkSlotPhase);
+		syncWorkSlot.perform();
+		DeadlineMonitor::exit(DeadlineMonitor::SyncWorkSlotPhase, syncWorkSlot.timeOfSlotEnd());
+		doLaterSlots(isFishing);
+	}
+	assert(!radio->isPowerOn());	// Low power for remainder of this sync period
+
+	// Slots must be done before next period's sync slot (e.g. fish slot not spill past SyncPoint)
+	DeadlineMonitor::exit(DeadlineMonitor::SlotSequencePhase, clique.schedule.timeOfNextSyncPoint());
+
+	radioPrewarm.startBefore(clique.schedule.timeOfNextSyncPoint());
+	syncSleeper.sleepUntil(clique.schedule.timeOfNextSyncPoint());
+	// Sync period completed
+}
+
+
+/*
+ * Slots after sync slot, separated from it by sleep.
+ */
+void CombinedSyncPeriod::doLaterSlots(bool isFishing) {
 	assert(!radio->isPowerOn());	// Low power until next slot
 
 	// Variation: next event (if any) occurs within a large sleeping time (lots of 'slots')
-	if (role.isMerger()) {
+	if (!isFishing) {
 		// avoid collision
 		if (mergeSlot.mergePolicy.shouldScheduleMerge())  {
+			// Slot measures itself (see DeadlineMonitor), from slot start after sleep
 			mergeSlot.perform();
 			// We might have quit role Merger
 		}
 		// else continue and sleep until end of sync period
 	}
 	else {
-		// Fish every period
+		// Fish every period.  Sync slot may have changed schedule since fish slot was chosen.
+		fishSlot.placeAfterSyncSlot();
 		fishSlot.perform();
 		// continue and sleep until end of sync period
 	}
-	assert(!radio->isPowerOn());	// Low power for remainder of this sync period
-
-	syncSleeper.sleepUntilTimeout(clique.schedule.deltaNowToNextSyncPoint);
-	// Sync period completed
 }
@@ -33,6 +33,8 @@ public:
  * Work must be rare, else it floods and hinders sync?
  */
 class CombinedSyncPeriod{
+private:
+	static void doLaterSlots(bool isFishing);
 
 public:
 	static void doSlotSequence();
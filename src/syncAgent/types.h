@@ -19,23 +19,27 @@ typedef uint32_t DeltaTime;
 
 
 /*
- * Used in scheduling to count slots and periods.
+ * Used in scheduling to count periods (and other small counts.)
  */
 // FUTURE since we aren't enforcing this, we might as well use native int
-// FUTURE distinguish PeriodCount from SlotCount
+// FUTURE distinguish PeriodCount
 typedef uint16_t ScheduleCount;
 
+/*
+ * Used in scheduling to count slots of a sync period, and as ordinal of a slot.
+ *
+ * Wider than ScheduleCount: ultra-low duty cycles (DutyCycleInverse 10k and more)
+ * have more slots per period than 16 bits.
+ */
+typedef uint32_t SlotCount;
+
 
 /*
- * This helps defines the MaximumDutyCycle.
- * !!! MaximumDutyCycle usually smaller, typically 10, 100, or 1024.
- * The limiting factor is use of rand() in randUnsignedInt()
- * which limits the max value to RAND_MAX, typically 32767.
+ * Saturation limit of counts of type ScheduleCount.
  *
- * Since we are awake for at least Sync and Work slots,
- * duty cycle is MaximumScheduleCount/2
+ * Was tied to RAND_MAX, no longer: random.h yields any 32-bit range.
+ * No longer limits duty cycle: slots are counted by SlotCount.
  */
-// FUTURE use this in some assertion
-static const uint16_t MaximumScheduleCount = 32767;	// !!! Same as std C RAND_MAX
+static const uint16_t MaximumScheduleCount = 32767;
 
 
@@ -0,0 +1,298 @@
+
+/*
+ * Host microbenchmark of the per-packet receive path:
+ * SyncSleeper (dispatchFilteredMsg) -> Serializer::unserialize -> SyncWorkSlot::dispatchMsgReceived
+ * -> SyncBehaviour::doSyncMsg -> Schedule::adjustBySyncMsg
+ *
+ * Drives the real SyncAgent code on the host platform (tools/hostPlatform) with synthetic radio buffers,
+ * one case per message type and clique relation.
+ * Each op is one SyncSleeper::sleepUntilMsgAcceptedOrDeadline: one packet, then timer expiry.
+ * Setup of each op (restoring clique, copying frame into radio buffer) is not timed.
+ *
+ * Reports per op: nanoseconds (median), instructions (mean, Linux perf counter if available), heap allocations.
+ * Timing and counting overhead is calibrated out with an empty op.
+ *
+ * Build (from this directory):
+ *   g++ -std=c++11 -O2 -I../hostPlatform -I../../src -o benchmark benchmark.cpp ../hostPlatform/hostPlatform.cpp \
+ *       $(find ../../src -name '*.cpp' ! -name main.cpp)
+ * Run:
+ *   ./benchmark                                         prints table
+ *   ./benchmark results.csv $(git rev-parse --short HEAD)  also appends rows to results.csv
+ *
+ * Assertions stay enabled (as in a Debug target build): they are part of the path on target too.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "hostPlatform.h"
+#include "syncAgent/globals.h"
+#include "syncAgent/syncAgent.h"
+#include "syncAgent/scheduleParameters.h"
+#include "syncAgent/slots/syncWorkSlot.h"
+
+
+/*
+ * Count heap allocations.  SyncAgent does not use heap: expect zero.
+ */
+namespace {
+unsigned long countAllocations = 0;
+}
+void* operator new(std::size_t size) {
+	countAllocations++;
+	void* result = malloc(size ? size : 1);
+	if (result == nullptr) throw std::bad_alloc();
+	return result;
+}
+void operator delete(void* pointer) noexcept { free(pointer); }
+
+
+namespace {
+
+const SystemID SelfID = 0x280;
+const SystemID MyMasterID = 0x200;	// Better than self (least ID is better)
+const SystemID BetterID = 0x100;
+const SystemID BetterUnreliableID = 0x150;
+const SystemID WorseID = 0x300;
+
+const LongTime StartTime = 1000000;
+const unsigned CountOps = 20000;
+
+
+// Instruction counter, user space only
+int perfFD = -1;
+
+void openInstructionCounter() {
+#ifdef __linux__
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(attr);
+	attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	perfFD = (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+	if (perfFD >= 0) {
+		ioctl(perfFD, PERF_EVENT_IOC_RESET, 0);
+		ioctl(perfFD, PERF_EVENT_IOC_ENABLE, 0);
+	}
+#endif
+}
+
+inline uint64_t readInstructions() {
+	uint64_t count = 0;
+#ifdef __linux__
+	if (perfFD >= 0 && read(perfFD, &count, sizeof(count)) != sizeof(count))
+		count = 0;
+#endif
+	return count;
+}
+
+inline uint64_t nowNanoseconds() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t) time.tv_sec * 1000000000u + (uint64_t) time.tv_nsec;
+}
+
+
+/*
+ * Host wake script for one op: one packet, then timer expiry.
+ */
+bool isPacketPending = false;
+
+ReasonForWake wakeOnePacket(LongTime deadline) {
+	if (isPacketPending) {
+		isPacketPending = false;
+		return MsgReceived;
+	}
+	if (HostPlatform::deadline() != 0 && LongClockTimer::nowTime() < deadline)
+		HostPlatform::setNow(deadline);
+	return TimerExpired;
+}
+
+LongTime deadlineOfOp() { return LongClockTimer::nowTime() + ScheduleParameters::VirtualSlotDuration; }
+
+
+struct Case {
+	const char* name;
+	uint8_t frame[Radio::FixedPayloadCount];
+	bool isCRCValid;
+	void (*restore)();
+};
+
+
+// Restore state before each op: self is slave of MyMasterID, mid sync slot
+void restoreSlave() {
+	HostPlatform::setNow(clique.schedule.startTimeOfSyncPeriod() + ScheduleParameters::DeltaToSyncSlotMiddle);
+	clique.setOtherMastership(MyMasterID);
+	linkQualityTable.reset();
+	HostPlatform::setRSSI(-60);
+}
+
+void restoreSlaveHeardBetter() {
+	restoreSlave();
+	// Link to better master is reliable
+	for (uint8_t i = 0; i < 32; i++)
+		linkQualityTable.heard(BetterID, -60);
+}
+
+void restoreSlaveHeardWeak() {
+	restoreSlave();
+	// Better master was heard before, weakly (a master never heard is presumed reliable)
+	HostPlatform::setRSSI(-100);
+	linkQualityTable.heard(BetterUnreliableID, -100);
+}
+
+void restoreNothing() {}
+
+
+/*
+ * Frame as sender would serialize it, offset as if sent in middle of sync slot.
+ */
+void makeFrame(Case* aCase, MessageType type, SystemID masterID) {
+	DeltaTime offset = ScheduleParameters::NormalSyncPeriodDuration - ScheduleParameters::DeltaToSyncSlotMiddle;
+	SyncMessage& msg = serializer.outwardCommonSyncMsg;
+	switch(type) {
+	case MasterSync: msg.makeMasterSync(offset, masterID); break;
+	case MergeSync: msg.makeMergeSync(offset, masterID); break;
+	case AbandonMastership: msg.makeAbandonMastership(masterID); break;
+	case WorkSync: msg.makeWorkSync(offset, masterID, 0x5A); break;
+	}
+	msg.hopCount = 0;
+	serializer.serializeOutwardCommonSyncMessage();
+	memcpy(aCase->frame, HostPlatform::radioBuffer(), sizeof(aCase->frame));
+}
+
+
+struct Result {
+	double nanoseconds;
+	double instructions;
+	double allocations;
+};
+
+template <typename Op>
+Result measure(void (*restore)(), const uint8_t* frame, bool isCRCValid, Op op) {
+	std::vector<uint64_t> nanoseconds;
+	nanoseconds.reserve(CountOps);
+	uint64_t instructions = 0;
+	unsigned long allocations = 0;
+
+	for (unsigned i = 0; i < CountOps; i++) {
+		restore();
+		if (frame != nullptr)
+			memcpy(HostPlatform::radioBuffer(), frame, Radio::FixedPayloadCount);
+		HostPlatform::setPacketCRCValid(isCRCValid);
+		unsigned long allocationsBefore = countAllocations;
+
+		uint64_t startInstructions = readInstructions();
+		uint64_t start = nowNanoseconds();
+		op();
+		uint64_t end = nowNanoseconds();
+		uint64_t endInstructions = readInstructions();
+
+		nanoseconds.push_back(end - start);
+		instructions += endInstructions - startInstructions;
+		allocations += countAllocations - allocationsBefore;
+	}
+	std::nth_element(nanoseconds.begin(), nanoseconds.begin() + CountOps / 2, nanoseconds.end());
+	Result result;
+	result.nanoseconds = (double) nanoseconds[CountOps / 2];
+	result.instructions = (double) instructions / CountOps;
+	result.allocations = (double) allocations / CountOps;
+	return result;
+}
+
+
+void onWorkMsg(WorkPayload) {}
+void onSyncPoint() {}
+
+void receiveOnePacket() {
+	radio->receiveStatic();
+	isPacketPending = true;
+	(void) syncSleeper.sleepUntilMsgAcceptedOrDeadline(SyncWorkSlot::dispatchMsgReceived, deadlineOfOp);
+}
+
+void emptyOp() {}
+
+}	// namespace
+
+
+int main(int argc, char** argv) {
+	if (argc != 1 && argc != 3) {
+		fprintf(stderr, "Usage: %s [<results.csv> <label>]\n", argv[0]);
+		return 2;
+	}
+
+	HostPlatform::setID(SelfID);
+	HostPlatform::setNow(StartTime);
+	Radio hostRadio;
+	Mailbox hostMailbox;
+	LongClockTimer hostLongClockTimer;
+	SyncAgent::init(&hostRadio, &hostMailbox, &hostLongClockTimer, onWorkMsg, onSyncPoint);
+	HostPlatform::setWakeFunc(wakeOnePacket);
+	openInstructionCounter();
+
+	std::vector<Case> cases;
+	Case aCase;
+	aCase.isCRCValid = true;
+
+	aCase.name = "MasterSync from my master";
+	aCase.restore = restoreSlave; makeFrame(&aCase, MasterSync, MyMasterID); cases.push_back(aCase);
+	aCase.name = "MasterSync from better master";
+	aCase.restore = restoreSlaveHeardBetter; makeFrame(&aCase, MasterSync, BetterID); cases.push_back(aCase);
+	aCase.name = "MasterSync better unreliable link";
+	aCase.restore = restoreSlaveHeardWeak; makeFrame(&aCase, MasterSync, BetterUnreliableID); cases.push_back(aCase);
+	aCase.name = "MasterSync from worse master";
+	aCase.restore = restoreSlave; makeFrame(&aCase, MasterSync, WorseID); cases.push_back(aCase);
+	aCase.name = "MergeSync from my clique";
+	aCase.restore = restoreSlave; makeFrame(&aCase, MergeSync, MyMasterID); cases.push_back(aCase);
+	aCase.name = "WorkSync from my clique";
+	aCase.restore = restoreSlave; makeFrame(&aCase, WorkSync, MyMasterID); cases.push_back(aCase);
+	aCase.name = "AbandonMastership from my clique";
+	aCase.restore = restoreSlave; makeFrame(&aCase, AbandonMastership, MyMasterID); cases.push_back(aCase);
+	aCase.name = "Garbled type";
+	aCase.restore = restoreSlave; makeFrame(&aCase, MasterSync, MyMasterID); aCase.frame[0] = 0xFF;
+	cases.push_back(aCase);
+	aCase.name = "Bad CRC";
+	aCase.restore = restoreSlave; makeFrame(&aCase, MasterSync, MyMasterID); aCase.isCRCValid = false;
+	cases.push_back(aCase);
+
+	Result overhead = measure(restoreNothing, nullptr, true, emptyOp);
+
+	FILE* csv = nullptr;
+	if (argc == 3) {
+		csv = fopen(argv[1], "a");
+		if (csv == nullptr) { perror(argv[1]); return 1; }
+	}
+
+	printf("%-36s %10s %14s %8s\n", "case", "ns/op", "instr/op", "allocs");
+	for (const Case& each : cases) {
+		Result result = measure(each.restore, each.frame, each.isCRCValid, receiveOnePacket);
+		double nanoseconds = std::max(0.0, result.nanoseconds - overhead.nanoseconds);
+		double instructions = std::max(0.0, result.instructions - overhead.instructions);
+		if (perfFD >= 0)
+			printf("%-36s %10.0f %14.0f %8.2f\n", each.name, nanoseconds, instructions, result.allocations);
+		else
+			printf("%-36s %10.0f %14s %8.2f\n", each.name, nanoseconds, "n/a", result.allocations);
+		if (csv != nullptr) {
+			if (perfFD >= 0)
+				fprintf(csv, "%s,%s,%.0f,%.0f,%.2f\n", argv[2], each.name, nanoseconds, instructions, result.allocations);
+			else
+				fprintf(csv, "%s,%s,%.0f,,%.2f\n", argv[2], each.name, nanoseconds, result.allocations);
+		}
+	}
+	if (csv != nullptr)
+		fclose(csv);
+	return 0;
+}
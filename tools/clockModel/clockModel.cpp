@@ -0,0 +1,144 @@
+#include <cassert>
+#include <cmath>
+
+#include "clockModel.h"
+
+
+const float ClockModel::Curvature = 0.034f;
+
+
+namespace {
+
+// Counter based: value for (seed, unit, counter) alone, so a loop over units has no carried dependency
+inline uint64_t hash(uint64_t seed, uint64_t unit, uint64_t counter) {
+	uint64_t z = seed ^ (unit * 0x9E3779B97F4A7C15ULL) ^ (counter * 0xD1B54A32D192ED03ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// In [-1, 1)
+inline float uniform(uint64_t bits) { return (float) (bits >> 40) / (float) (1 << 23) - 1.0f; }
+
+// 32 bit: vectorizes without 64 bit multiplies (lowbias32)
+inline uint32_t hash32(uint32_t x) {
+	x ^= x >> 16;
+	x *= 0x7FEB352DU;
+	x ^= x >> 15;
+	x *= 0x846CA68BU;
+	x ^= x >> 16;
+	return x;
+}
+
+// Approximately normal, unit variance: sum of four uniforms (16 bits each) of two hashes
+inline float normal(uint32_t key) {
+	uint32_t first = hash32(key);
+	uint32_t second = hash32(first ^ 0x9E3779B9U);
+	float sum = (float) (first & 0xFFFF) + (float) (first >> 16) + (float) (second & 0xFFFF) + (float) (second >> 16);
+	// Each uniform in [0, 65536): mean 32768, variance 65536^2 / 12
+	return (sum - 4 * 32768.0f) * (1.7320508f / (2 * 65536.0f));
+}
+
+}	// namespace
+
+
+
+ClockModel::ClockModel(uint32_t countUnits, uint64_t aSeed, const ClockParameters& aParameters) :
+		parameters(aParameters),
+		seed(aSeed),
+		staticPPM(countUnits),
+		turnover(countUnits),
+		phase(countUnits),
+		localAtStep(countUnits, 0.0),
+		rate(countUnits, 1.0)
+{
+	assert(parameters.stepTicks > 0);
+	for (uint32_t unit = 0; unit < countUnits; unit++) {
+		staticPPM[unit] = parameters.staticPPM * uniform(hash(seed, unit, 0));
+		turnover[unit] = parameters.turnoverCelsius + parameters.turnoverSpread * uniform(hash(seed, unit, 1));
+		phase[unit] = parameters.phaseSpread * uniform(hash(seed, unit, 2));
+	}
+	computeRates();
+}
+
+
+/*
+ * localAtStep is negative until boot.
+ * Exact if boot is in the current step, else reading at boot is within a fraction of a tick of zero.
+ */
+void ClockModel::boot(uint32_t unit, uint64_t bootTime) {
+	assert(bootTime >= stepStart);
+	localAtStep[unit] = -(double) (bootTime - stepStart) * rate[unit];
+}
+
+
+void ClockModel::advance(uint64_t trueTime) {
+	while (trueTime >= nextStep()) {
+		// Close this step: every unit's reading at its end, at this step's rate
+		double elapsed = parameters.stepTicks;
+		size_t count = rate.size();
+		double* local = localAtStep.data();
+		const double* unitRate = rate.data();
+		for (size_t unit = 0; unit < count; unit++)
+			local[unit] += elapsed * unitRate[unit];
+
+		stepStart += parameters.stepTicks;
+		countSteps++;
+		computeRates();
+	}
+}
+
+
+/*
+ * Rate of every unit for the step starting at stepStart.
+ * Phase noise is a rate over the step: phase walks, clock stays monotonic (noise is much less than a step.)
+ */
+void ClockModel::computeRates() {
+	const float TwoPi = 6.2831853f;
+	float dayFraction = (float) fmod((double) stepStart / parameters.dayTicks, 1.0);
+	ambient = parameters.meanCelsius + parameters.swingCelsius * sinf(TwoPi * dayFraction);
+	float lagPerPhase = parameters.swingCelsius * TwoPi * cosf(TwoPi * dayFraction);
+	float noisePerTick = parameters.phaseNoise / parameters.stepTicks;
+
+	// Locals: no aliasing with stores to rate, for the vectorizer
+	float stepAmbient = ambient;
+	float curvature = Curvature;
+	uint32_t stepKey = hash32((uint32_t) seed ^ hash32((uint32_t) countSteps));
+	uint32_t count = (uint32_t) rate.size();
+	double* unitRate = rate.data();
+	const float* unitStatic = staticPPM.data();
+	const float* unitTurnover = turnover.data();
+	const float* unitPhase = phase.data();
+	for (uint32_t unit = 0; unit < count; unit++) {
+		// Cycle of a unit lags ambient by its phase: linearized, sin(a - p) ~ sin(a) - p cos(a)
+		float celsius = stepAmbient - lagPerPhase * unitPhase[unit];
+		float offTurnover = celsius - unitTurnover[unit];
+		float ppm = unitStatic[unit] - curvature * offTurnover * offTurnover;
+		float noise = noisePerTick * normal(stepKey + unit * 0x9E3779B9U);
+		unitRate[unit] = 1.0 + (double) (1e-6f * ppm + noise);
+	}
+}
+
+
+uint64_t ClockModel::localTime(uint32_t unit, uint64_t trueTime) const {
+	assert(trueTime >= stepStart && trueTime < nextStep());
+	return reading(unit, trueTime);
+}
+
+// At current step's rate, also beyond it
+uint64_t ClockModel::reading(uint32_t unit, uint64_t trueTime) const {
+	double local = localAtStep[unit] + (double) (trueTime - stepStart) * rate[unit];
+	return (local > 0) ? (uint64_t) local : 0;
+}
+
+
+uint64_t ClockModel::trueTime(uint32_t unit, uint64_t localTime) const {
+	double elapsed = ((double) localTime - localAtStep[unit]) / rate[unit];
+	uint64_t result = stepStart + ((elapsed > 0) ? (uint64_t) ceil(elapsed) : 0);
+	// Rounding of the division: first true tick reading at least localTime
+	while (result > stepStart && reading(unit, result - 1) >= localTime)
+		result--;
+	while (reading(unit, result) < localTime)
+		result++;
+	return result;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <inttypes.h>
+#include <vector>
+
+
+/*
+ * Model of the 32kHz crystals of many units, for simulation.
+ *
+ * A unit's clock counts local ticks as true (simulated) time passes.
+ * Its rate departs from nominal by:
+ * - static skew: manufacturing tolerance, uniform in +-staticPPM, fixed per unit
+ * - temperature: a tuning fork crystal slows parabolically away from its turnover temperature
+ *   (-Curvature ppm per degree squared.)  Ambient temperature follows a day/night cycle (solar nodes outdoors),
+ *   each unit's turnover temperature and phase of the cycle differ a little.
+ * - phase noise: a random walk of phase, a normal step of phaseNoise ticks (standard deviation) per Step
+ * Reading is quantized: a clock reads whole ticks (floor.)
+ *
+ * Rates change only at steps (every Step true ticks), so between steps a clock is linear:
+ * reading and its inverse (true time a clock reaches a local time, for timers) are exact within a step.
+ * A deadline beyond the current step is an estimate: caller checks it on arrival (see Simulation.)
+ *
+ * Vectorized: state is arrays over units (structure of arrays), and advance() updates every unit in one pass
+ * of arithmetic the compiler vectorizes (the random numbers are a counter based hash, not a sequential generator.)
+ * Deterministic for a seed: same clocks in every run of a simulation.
+ *
+ * Policy::maxMissingSyncsPerDropout assumes 20ppm drift.  Static skew alone is that, relative to a perfect clock;
+ * two units can differ by twice that, more at the extremes of temperature.
+ */
+
+struct ClockParameters {
+	float staticPPM = 20;	// Half width of uniform distribution
+	float turnoverCelsius = 25;	// Of crystal, nominal
+	float turnoverSpread = 5;	// Half width, per unit
+	float meanCelsius = 20;	// Ambient
+	float swingCelsius = 10;	// Amplitude of day/night cycle
+	float dayTicks = 86400.0f * 32768;	// Length of cycle, true ticks.  Shorter to compress days into a short simulation.
+	float phaseSpread = 0.05f;	// Of each unit's cycle, fraction of a day (shade, orientation)
+	float phaseNoise = 0.02f;	// Ticks, standard deviation per step
+	uint32_t stepTicks = 32768;	// One second
+};
+
+
+class ClockModel {
+public:
+	static const float Curvature;	// ppm per degree squared, typical of 32768Hz tuning forks
+
+	ClockModel(uint32_t countUnits, uint64_t seed, const ClockParameters& parameters);
+
+	// Local tick 0 at true time bootTime, not before current step
+	void boot(uint32_t unit, uint64_t bootTime);
+
+	// Advance all clocks to the step containing trueTime.  Call before reading at trueTime.
+	void advance(uint64_t trueTime);
+	uint64_t nextStep() const { return stepStart + parameters.stepTicks; }
+
+	// Quantized reading, zero before boot
+	uint64_t localTime(uint32_t unit, uint64_t trueTime) const;
+	// Earliest true time (in the current step's rates) at which reading is at least localTime
+	uint64_t trueTime(uint32_t unit, uint64_t localTime) const;
+
+	// Of the current step, departure from nominal
+	float ppm(uint32_t unit) const { return (float) ((rate[unit] - 1.0) * 1e6); }
+	float celsius() const { return ambient; }
+
+private:
+	ClockParameters parameters;
+	uint64_t seed;
+	uint64_t countSteps = 0;
+	uint64_t stepStart = 0;	// True time
+	float ambient;
+
+	// Per unit
+	std::vector<float> staticPPM;
+	std::vector<float> turnover;
+	std::vector<float> phase;	// Of day, fraction
+	std::vector<double> localAtStep;	// Fractional ticks, at stepStart
+	std::vector<double> rate;	// Local ticks per true tick, this step
+
+	void computeRates();
+	uint64_t reading(uint32_t unit, uint64_t trueTime) const;
+};
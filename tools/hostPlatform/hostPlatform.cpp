@@ -0,0 +1,137 @@
+
+#include <cstdio>
+#include <cstring>
+
+#include "hostPlatform.h"
+
+
+namespace {
+
+LongTime now = 0;
+LongTime armedDeadline = 0;
+HostPlatform::WakeFunc wakeFunc = nullptr;
+ReasonForWake reasonForWake = None;
+
+SystemID id = 0x123456789AULL;
+
+uint8_t buffer[Radio::FixedPayloadCount];
+bool isCRCValid = true;
+int8_t rssi = -60;
+bool isRadioPowerOn = false;
+bool isReceiving = false;
+uint32_t transmits = 0;
+
+bool isHFXORunning = false;
+bool isRadioPowered = true;
+bool isLogging = false;
+
+uint8_t retained[64];
+bool isRetainedWritten = false;
+
+}	// namespace
+
+
+// Control by host
+
+void HostPlatform::setWakeFunc(WakeFunc aWakeFunc) { wakeFunc = aWakeFunc; }
+void HostPlatform::setNow(LongTime aNow) { now = aNow; }
+void HostPlatform::advance(OSTime ticks) { now += ticks; }
+LongTime HostPlatform::deadline() { return armedDeadline; }
+void HostPlatform::setID(SystemID anID) { id = anID; }
+uint8_t* HostPlatform::radioBuffer() { return buffer; }
+void HostPlatform::setPacketCRCValid(bool isValid) { isCRCValid = isValid; }
+void HostPlatform::setRSSI(int8_t anRSSI) { rssi = anRSSI; }
+uint32_t HostPlatform::countTransmits() { return transmits; }
+void HostPlatform::setPowerForRadio(bool isPower) { isRadioPowered = isPower; }
+void HostPlatform::setLogging(bool isOn) { isLogging = isOn; }
+
+
+// Platform API
+
+void initLogging() {}
+void log(const char* aString) { if (isLogging) fputs(aString, stdout); }
+void logInt(uint32_t value) { if (isLogging) printf("%u", value); }
+void logLongLong(uint64_t value) { if (isLogging) printf("%llu", (unsigned long long) value); }
+
+SystemID myID() { return id; }
+
+
+void HfCrystalClock::start() { isHFXORunning = true; }
+void HfCrystalClock::startAndSleepUntilRunning() { isHFXORunning = true; }
+void HfCrystalClock::stop() { isHFXORunning = false; }
+bool HfCrystalClock::isRunning() { return isHFXORunning; }
+
+
+void Radio::setMsgReceivedCallback(void (*)()) {}
+void Radio::configureNetworkAddress(uint32_t, uint8_t) {}
+void Radio::powerOnAndConfigure() { isRadioPowerOn = true; }
+void Radio::configureXmitPower(int8_t) {}
+void Radio::configureChannel(uint8_t) {}
+void Radio::powerOff() { isRadioPowerOn = false; isReceiving = false; }
+bool Radio::isPowerOn() { return isRadioPowerOn; }
+bool Radio::isDisabledState() { return !isReceiving; }
+void Radio::transmitStaticSynchronously() { transmits++; }
+void Radio::receiveStatic() { isReceiving = true; }
+bool Radio::isEnabledInterruptForMsgReceived() { return isReceiving; }
+void Radio::stopReceive() { isReceiving = false; }
+BufferPointer Radio::getBufferAddress() { return buffer; }
+bool Radio::isPacketCRCValid() { return isCRCValid; }
+bool Radio::isChannelClear() { return true; }
+int8_t Radio::receivedSignalStrength() { return rssi; }
+
+
+LongTime LongClockTimer::nowTime() { return now; }
+void LongClockTimer::reset() {}
+
+
+void Sleeper::init(OSTime, LongClockTimer*) {}
+
+void Sleeper::sleepUntilEventWithTimeout(OSTime timeout) {
+	setDeadline(now + timeout);
+	sleepUntilEvent();
+}
+
+void Sleeper::cancelTimeout() { armedDeadline = 0; }
+void Sleeper::setDeadline(LongTime aDeadline) { armedDeadline = aDeadline; }
+
+void Sleeper::sleepUntilEvent() {
+	if (wakeFunc != nullptr) {
+		reasonForWake = wakeFunc(armedDeadline);
+	}
+	else {
+		if (now < armedDeadline)
+			now = armedDeadline;
+		reasonForWake = TimerExpired;
+	}
+	// Like target: receiving ends when a packet is received (radio DISABLED)
+	if (reasonForWake == MsgReceived)
+		isReceiving = false;
+	else if (reasonForWake == TimerExpired)
+		armedDeadline = 0;
+}
+
+ReasonForWake Sleeper::getReasonForWake() { return reasonForWake; }
+void Sleeper::clearReasonForWake() { reasonForWake = None; }
+void Sleeper::msgReceivedCallback() { reasonForWake = MsgReceived; }
+
+
+void Mailbox::put(WorkPayload) {}
+WorkPayload Mailbox::fetch() { return 0; }
+bool Mailbox::isMail() { return false; }
+
+void LEDLogger::init() {}
+void LEDLogger::toggleLED(int) {}
+
+bool PowerManager::isPowerForRadio() { return isRadioPowered; }
+
+
+uint16_t RetainedMemory::size() { return sizeof(retained); }
+void RetainedMemory::read(uint8_t* data, uint16_t count) { memcpy(data, retained, count); }
+void RetainedMemory::write(const uint8_t* data, uint16_t count) {
+	memcpy(retained, data, count);
+	isRetainedWritten = true;
+}
+bool RetainedMemory::ticksSinceWrite(uint64_t* ticks) {
+	*ticks = 0;
+	return isRetainedWritten;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <nRF5x.h>
+
+/*
+ * Control of host platform by host program (benchmark, tests, simulator.)
+ *
+ * Time stands still unless the host advances it, or a sleep with no WakeFunc passes its deadline.
+ * Radio receives only what the host puts in its buffer, when the host's WakeFunc says so.
+ */
+namespace HostPlatform {
+
+/*
+ * Called when SyncAgent sleeps.  Returns reason for wake.
+ * May advance time, and fill radio buffer before returning MsgReceived.
+ * No WakeFunc: every sleep advances time to deadline and returns TimerExpired.
+ */
+typedef ReasonForWake (*WakeFunc)(LongTime deadline);
+void setWakeFunc(WakeFunc);
+
+void setNow(LongTime);
+void advance(OSTime ticks);
+LongTime deadline();	// Armed, or zero
+
+void setID(SystemID);
+
+uint8_t* radioBuffer();
+void setPacketCRCValid(bool);
+void setRSSI(int8_t);
+uint32_t countTransmits();
+
+void setPowerForRadio(bool);
+
+// Quiet: log() discarded (default.)  Else printed.
+void setLogging(bool);
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+/*
+ * Host platform: the platform API SyncAgent includes as <nRF5x.h>, implemented on a workstation.
+ *
+ * Stands in for the nRF5x library that wedges SyncAgent on target.
+ * Declares only what SyncAgent uses.
+ * The host controls the platform (clock, radio buffer, reasons for wake) through HostPlatform (hostPlatform.h.)
+ *
+ * Not a simulator of radio physics: one unit, inputs scripted by the host program.
+ */
+
+#include <inttypes.h>
+#include <cstdlib>
+
+#include "types.h"
+#include "config.h"	// SYNC_AGENT_COMPACT_OTA, SYNC_AGENT_WIDE_OFFSET (from SyncAgent's source)
+
+const uint8_t OSClockCountBits = 24;
+const uint32_t MaxDeltaTime = 0xFFFFFF;
+
+void initLogging();
+void log(const char*);
+void logInt(uint32_t);
+void logLongLong(uint64_t);
+
+SystemID myID();
+
+
+class HfCrystalClock {
+public:
+	static void start();
+	static void startAndSleepUntilRunning();
+	static void stop();
+	static bool isRunning();
+};
+
+
+class Radio {
+public:
+	// Length of SyncAgent's OTA payload (see OTAPayload) as configured, so host tools build with any config
+#if defined(SYNC_AGENT_COMPACT_OTA) && defined(SYNC_AGENT_WIDE_OFFSET)
+	static const uint8_t FixedPayloadCount = 10;
+#elif defined(SYNC_AGENT_COMPACT_OTA)
+	static const uint8_t FixedPayloadCount = 9;
+#elif defined(SYNC_AGENT_WIDE_OFFSET)
+	static const uint8_t FixedPayloadCount = 13;
+#else
+	static const uint8_t FixedPayloadCount = 12;
+#endif
+	HfCrystalClock* hfCrystalClock;
+
+	static void setMsgReceivedCallback(void (*)());
+	static void configureNetworkAddress(uint32_t base, uint8_t prefix);
+	static void powerOnAndConfigure();
+	static void configureXmitPower(int8_t dBm);
+	static void configureChannel(uint8_t);
+	static void powerOff();
+	static bool isPowerOn();
+	static bool isDisabledState();
+	static void transmitStaticSynchronously();
+	static void receiveStatic();
+	static bool isEnabledInterruptForMsgReceived();
+	static void stopReceive();
+	static BufferPointer getBufferAddress();
+	static bool isPacketCRCValid();
+	static bool isChannelClear();
+	static int8_t receivedSignalStrength();
+};
+
+
+enum ReasonForWake { MsgReceived, TimerExpired, None };
+
+
+class LongClockTimer {
+public:
+	static const OSTime MaxTimeout = 0xFFFFFF;
+	static LongTime nowTime();
+	static void reset();
+};
+
+
+class Sleeper {
+public:
+	static void init(OSTime maxSaneTimeout, LongClockTimer*);
+	static void sleepUntilEventWithTimeout(OSTime);
+	static void cancelTimeout();
+	static void setDeadline(LongTime);
+	static void sleepUntilEvent();
+	static ReasonForWake getReasonForWake();
+	static void clearReasonForWake();
+	static void msgReceivedCallback();
+};
+
+
+class Mailbox {
+public:
+	static void put(WorkPayload);
+	static WorkPayload fetch();
+	static bool isMail();
+};
+
+class LEDLogger {
+public:
+	static void init();
+	static void toggleLED(int);
+};
+
+class PowerManager {
+public:
+	static bool isPowerForRadio();
+};
+
+class RetainedMemory {
+public:
+	static uint16_t size();
+	static void read(uint8_t*, uint16_t);
+	static void write(const uint8_t*, uint16_t);
+	static bool ticksSinceWrite(uint64_t*);
+};
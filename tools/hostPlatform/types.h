@@ -0,0 +1,13 @@
+#pragma once
+
+#include <inttypes.h>
+
+/*
+ * Host platform: fundamental types between platform and SyncAgent (see src/platformHeaders/types.h.)
+ */
+
+typedef uint32_t OSTime;
+typedef uint64_t LongTime;
+typedef uint64_t SystemID;
+typedef uint32_t WorkPayload;
+typedef volatile uint8_t * BufferPointer;
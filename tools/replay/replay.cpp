@@ -0,0 +1,395 @@
+/*
+ * Host tool: replay a recording of SyncAgent's inputs (see src/syncAgent/modules/inputRecorder.h.)
+ *
+ * This file is the platform (nRF5x.h API, declared in tools/hostPlatform): it serves recorded inputs in order
+ * to an unmodified SyncAgent::loop().
+ * SyncAgent, built with SYNC_AGENT_RECORD_INPUTS, records again as it replays.
+ * Replay checks the new recording against the old, record by record: inputs and decisions (traced events.)
+ *
+ * Recording is a ring.  If it has not wrapped, replay starts at SyncAgent::init.
+ * Else replay starts at the oldest restart in the ring (see SyncCheckpoint::periodicSave):
+ * SyncAgent inits without reading the recording, then resumes the recorded state (SyncAgent::loopFromRestart.)
+ * State that a restart doesn't record (e.g. role Merger) is as after init: a replay from restart may diverge
+ * where a replay from init would not.
+ *
+ * Ends when the recording is exhausted (exit 0), or at the first divergence (exit 1), printing the index
+ * (from start of replay) and both records.  Divergence means SyncAgent decided differently, or asked for an input it didn't ask for on target.
+ * Replay needs the same source and configuration as the recorded build, otherwise it diverges early.
+ *
+ * Usage:
+ * - on target, debugger dumps memory: gdb "dump binary value inputs.bin inputRecording"
+ * - on host: replay [-v] inputs.bin    (-v: print decisions and SyncAgent's log as replayed)
+ *
+ * Build (from this directory):
+ *   g++ -std=c++11 -O2 -g -DSYNC_AGENT_RECORD_INPUTS=1 -I../hostPlatform -I../../src -o replay replay.cpp \
+ *       $(find ../../src -name '*.cpp' ! -name main.cpp)
+ *
+ * Replay is single threaded and never sleeps: run it under gdb to bisect (break on a record index),
+ * or under perf to profile the SyncAgent of a field incident.
+ * Assumes host is little-endian like target (nRF5x.)
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <nRF5x.h>
+#include "syncAgent/globals.h"
+#include "syncAgent/syncAgent.h"
+#include "syncAgent/logMessage.h"
+#include "syncAgent/modules/inputRecorder.h"
+
+#ifndef SYNC_AGENT_RECORD_INPUTS
+#error "Replay requires SyncAgent built with SYNC_AGENT_RECORD_INPUTS."
+#endif
+
+
+namespace {
+
+InputRecording dump;	// From target, a ring
+InputRecording recorded;	// Linear, from start of replay.  The replay records to inputRecording.
+bool isFromRestart = false;
+// While SyncAgent inits before a replay from restart: inputs are zero, not from recording
+bool isSettingUp = false;
+uint32_t countVerified = 0;
+uint32_t countDecisions = 0;
+bool isVerbose = false;
+uint64_t startNanoseconds;
+
+uint8_t buffer[Radio::FixedPayloadCount];
+bool isRadioPowerOn = false;
+bool isReceiving = false;
+ReasonForWake reasonForWake = None;
+bool isReasonServed = false;
+
+
+const char* nameOfKind(uint8_t kind) {
+	switch(kind) {
+	case InputRecorder::Empty: return "empty";
+	case InputRecorder::Identity: return "identity";
+	case InputRecorder::Clock: return "clock";
+	case InputRecorder::Wake: return "wake";
+	case InputRecorder::Payload: return "payload";
+	case InputRecorder::CRCValid: return "CRC valid";
+	case InputRecorder::SignalStrength: return "RSSI";
+	case InputRecorder::ChannelClear: return "channel clear";
+	case InputRecorder::PowerForRadio: return "power for radio";
+	case InputRecorder::CrystalRunning: return "HFXO running";
+	case InputRecorder::Mail: return "mail";
+	case InputRecorder::WorkFetched: return "work fetched";
+	case InputRecorder::RetainedSize: return "retained size";
+	case InputRecorder::RetainedBytes: return "retained bytes";
+	case InputRecorder::RetainedAge: return "retained age";
+	case InputRecorder::Decision: return "decision";
+	case InputRecorder::Restart: return "restart";
+	case InputRecorder::RestartState: return "restart state";
+	default: return "?";
+	}
+}
+
+void printRecord(const char* label, const InputRecord& record) {
+	printf("  %-9s %-16s", label, nameOfKind(record.kind));
+	if (record.kind == InputRecorder::Decision)
+		printf("%s %u\n", LogMessage::nameOf(record.data[0]), record.value);
+	else
+		printf("data %02x %02x %02x value %u\n", record.data[0], record.data[1], record.data[2], record.value);
+}
+
+uint64_t nowNanoseconds() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t) time.tv_sec * 1000000000u + (uint64_t) time.tv_nsec;
+}
+
+bool isSameRecord(const InputRecord& a, const InputRecord& b) {
+	return a.kind == b.kind
+			&& a.data[0] == b.data[0] && a.data[1] == b.data[1] && a.data[2] == b.data[2]
+			&& a.value == b.value;
+}
+
+
+void diverged(uint32_t index, const char* reason) {
+	printf("Diverged at record %u of %u: %s\n", index, recorded.countRecorded, reason);
+	if (index < recorded.countRecorded)
+		printRecord("recorded", recorded.records[index]);
+	if (index < inputRecording.countRecorded)
+		printRecord("replayed", inputRecording.records[index]);
+	exit(1);
+}
+
+
+/*
+ * Compare what replay recorded since last verify.
+ */
+void verify() {
+	uint32_t end = inputRecording.countRecorded;
+	if (end > recorded.countRecorded)
+		end = recorded.countRecorded;
+	for (; countVerified < end; countVerified++) {
+		const InputRecord& record = inputRecording.records[countVerified];
+		if (!isSameRecord(record, recorded.records[countVerified]))
+			diverged(countVerified, "different record");
+		if (record.kind == InputRecorder::Decision) {
+			countDecisions++;
+			if (isVerbose)
+				printf("%8u  %s %u\n", countVerified, LogMessage::nameOf(record.data[0]), record.value);
+		}
+	}
+}
+
+
+void finish() {
+	verify();
+	double seconds = (nowNanoseconds() - startNanoseconds) / 1e9;
+	printf("Replayed %u records, %u decisions, same as recorded (%.3f s.)\n",
+			countVerified, countDecisions, seconds);
+	exit(0);
+}
+
+
+/*
+ * Next recorded input, which must be of kind SyncAgent asks for.
+ * Replay's recorder records it next, at the same index.
+ */
+const InputRecord& expect(InputRecorder::Kind kind) {
+	static const InputRecord zero = {};
+	if (isSettingUp)
+		return zero;
+
+	verify();
+	uint32_t index = inputRecording.countRecorded;
+	if (index >= recorded.countRecorded)
+		finish();
+	if (recorded.records[index].kind != kind) {
+		char reason[64];
+		snprintf(reason, sizeof(reason), "SyncAgent asked for %s", nameOfKind(kind));
+		diverged(index, reason);
+	}
+	return recorded.records[index];
+}
+
+/*
+ * Bytes of consecutive records following index.  Missing if recording stopped: zero.
+ */
+void copyBytes(uint32_t index, InputRecorder::Kind kind, volatile uint8_t* data, uint16_t count) {
+	for (uint16_t i = 0; i < count; i++) {
+		uint32_t recordIndex = index + i / InputRecord::CountBytes;
+		if (recordIndex < recorded.countRecorded && recorded.records[recordIndex].kind == kind)
+			data[i] = recorded.records[recordIndex].byteAt(i % InputRecord::CountBytes);
+		else
+			data[i] = 0;
+	}
+}
+
+
+/*
+ * Records of ring, oldest first, from index in that order.
+ */
+const InputRecord& dumpedRecord(uint32_t index) {
+	// Until ring wraps, oldest is at zero
+	uint32_t first = (dump.countRecorded > InputRecording::CountRecords) ?
+			dump.countRecorded % InputRecording::CountRecords : 0;
+	return dump.records[(first + index) % InputRecording::CountRecords];
+}
+
+uint32_t countRecordsOfBytes(uint32_t countBytes) {
+	return (countBytes + InputRecord::CountBytes - 1) / InputRecord::CountBytes;
+}
+
+
+bool load(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (file == nullptr) {
+		perror(path);
+		return false;
+	}
+	memset(&dump, 0, sizeof(dump));
+	// Header, then as many records as recorded
+	size_t countRead = fread(&dump, 1, sizeof(dump), file);
+	fclose(file);
+	bool isWrapped = dump.countRecorded > InputRecording::CountRecords;
+	uint32_t countInRing = isWrapped ? InputRecording::CountRecords : dump.countRecorded;
+	if (countRead < offsetof(InputRecording, records)
+			|| dump.magic != InputRecording::Magic
+			|| countRead < offsetof(InputRecording, records) + countInRing * sizeof(InputRecord)) {
+		fprintf(stderr, "Not a recording (or build with different layout.)\n");
+		return false;
+	}
+
+	uint32_t start = 0;
+	if (isWrapped) {
+		// Oldest restart whose state is wholly in ring
+		for (start = 0; start < countInRing; start++) {
+			const InputRecord& record = dumpedRecord(start);
+			if (record.kind == InputRecorder::Restart
+					&& start + 1 + countRecordsOfBytes(record.value) <= countInRing)
+				break;
+		}
+		if (start == countInRing) {
+			fprintf(stderr, "Recording wrapped, and has no restart.\n");
+			return false;
+		}
+		isFromRestart = true;
+	}
+	else if (countInRing < 2 || dumpedRecord(0).kind != InputRecorder::Identity) {
+		fprintf(stderr, "Recording does not start at SyncAgent::init.\n");
+		return false;
+	}
+
+	memset(&recorded, 0, sizeof(recorded));
+	recorded.magic = dump.magic;
+	recorded.id = dump.id;
+	for (uint32_t index = start; index < countInRing; index++)
+		recorded.records[recorded.countRecorded++] = dumpedRecord(index);
+	return true;
+}
+
+}	// namespace
+
+
+
+// Platform API, inputs from recording
+
+void initLogging() {}
+void log(const char* aString) { if (isVerbose) fputs(aString, stdout); }
+void logInt(uint32_t value) { if (isVerbose) printf("%u", value); }
+void logLongLong(uint64_t value) { if (isVerbose) printf("%llu", (unsigned long long) value); }
+
+// Not an input per read: constant, recorded once
+SystemID myID() { return recorded.id; }
+
+
+void HfCrystalClock::start() {}
+void HfCrystalClock::startAndSleepUntilRunning() {}
+void HfCrystalClock::stop() {}
+bool HfCrystalClock::isRunning() { return expect(InputRecorder::CrystalRunning).data[0]; }
+
+
+// Radio state is not input: replay tracks it so SyncAgent's assertions hold
+void Radio::setMsgReceivedCallback(void (*)()) {}
+void Radio::configureNetworkAddress(uint32_t, uint8_t) {}
+void Radio::powerOnAndConfigure() { isRadioPowerOn = true; }
+void Radio::configureXmitPower(int8_t) {}
+void Radio::configureChannel(uint8_t) {}
+void Radio::powerOff() { isRadioPowerOn = false; isReceiving = false; }
+bool Radio::isPowerOn() { return isRadioPowerOn; }
+bool Radio::isDisabledState() { return !isReceiving; }
+void Radio::transmitStaticSynchronously() {}
+void Radio::receiveStatic() { isReceiving = true; }
+bool Radio::isEnabledInterruptForMsgReceived() { return isReceiving; }
+void Radio::stopReceive() { isReceiving = false; }
+BufferPointer Radio::getBufferAddress() { return buffer; }
+bool Radio::isPacketCRCValid() { return expect(InputRecorder::CRCValid).data[0]; }
+bool Radio::isChannelClear() { return expect(InputRecorder::ChannelClear).data[0]; }
+int8_t Radio::receivedSignalStrength() { return (int8_t) expect(InputRecorder::SignalStrength).data[0]; }
+
+
+LongTime LongClockTimer::nowTime() { return expect(InputRecorder::Clock).wideValue(); }
+void LongClockTimer::reset() {}
+
+
+void Sleeper::init(OSTime, LongClockTimer*) {}
+void Sleeper::sleepUntilEventWithTimeout(OSTime) { sleepUntilEvent(); }
+void Sleeper::cancelTimeout() {}
+void Sleeper::setDeadline(LongTime) {}
+
+// Time passes in the recorded clock readings, not here
+void Sleeper::sleepUntilEvent() { isReasonServed = false; }
+
+ReasonForWake Sleeper::getReasonForWake() {
+	if (!isReasonServed) {
+		uint32_t index = inputRecording.countRecorded;
+		reasonForWake = (ReasonForWake) expect(InputRecorder::Wake).data[0];
+		if (reasonForWake == MsgReceived) {
+			// Like target: receiving ends when a packet is received
+			copyBytes(index + 1, InputRecorder::Payload, buffer, Radio::FixedPayloadCount);
+			isReceiving = false;
+		}
+		isReasonServed = true;
+	}
+	return reasonForWake;
+}
+
+void Sleeper::clearReasonForWake() { reasonForWake = None; }
+void Sleeper::msgReceivedCallback() {}
+
+
+void Mailbox::put(WorkPayload) {}
+WorkPayload Mailbox::fetch() { return expect(InputRecorder::WorkFetched).value; }
+bool Mailbox::isMail() { return expect(InputRecorder::Mail).data[0]; }
+
+void LEDLogger::init() {}
+void LEDLogger::toggleLED(int) {}
+
+bool PowerManager::isPowerForRadio() { return expect(InputRecorder::PowerForRadio).data[0]; }
+
+
+uint16_t RetainedMemory::size() { return (uint16_t) expect(InputRecorder::RetainedSize).value; }
+void RetainedMemory::read(uint8_t* data, uint16_t count) {
+	uint32_t index = inputRecording.countRecorded;
+	(void) expect(InputRecorder::RetainedBytes);
+	copyBytes(index, InputRecorder::RetainedBytes, data, count);
+}
+void RetainedMemory::write(const uint8_t*, uint16_t) {}
+bool RetainedMemory::ticksSinceWrite(uint64_t* ticks) {
+	const InputRecord& record = expect(InputRecorder::RetainedAge);
+	*ticks = record.wideValue();
+	return record.data[0];
+}
+
+
+
+namespace {
+void onWorkMsg(WorkPayload) {}
+void onSyncPoint() {}
+}
+
+
+int main(int argc, char** argv) {
+	const char* path = nullptr;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-v") == 0)
+			isVerbose = true;
+		else
+			path = argv[i];
+	}
+	if (path == nullptr) {
+		fprintf(stderr, "Usage: %s [-v] <recording dump>\n", argv[0]);
+		return 2;
+	}
+	if (!load(path))
+		return 1;
+	printf("Recording of unit %llx, %u records since init, replaying %u from %s\n",
+			(unsigned long long) myID(),
+			dump.countRecorded,
+			recorded.countRecorded,
+			isFromRestart ? "restart" : "init");
+
+	startNanoseconds = nowNanoseconds();
+
+	Radio replayRadio;
+	Mailbox replayMailbox;
+	LongClockTimer replayLongClockTimer;
+	if (!isFromRestart) {
+		SyncAgent::init(&replayRadio, &replayMailbox, &replayLongClockTimer, onWorkMsg, onSyncPoint);
+		SyncAgent::loop();	// Never returns: replay ends in finish() or diverged()
+	}
+
+	isSettingUp = true;
+	SyncAgent::init(&replayRadio, &replayMailbox, &replayLongClockTimer, onWorkMsg, onSyncPoint);
+	isSettingUp = false;
+
+	// Restart is first record: record it again, as target did, and verify it like any other
+	uint8_t state[256];
+	uint32_t countStateBytes = recorded.records[0].value;
+	if (countStateBytes > sizeof(state)) {
+		fprintf(stderr, "Restart state larger than replay expects.\n");
+		return 1;
+	}
+	copyBytes(1, InputRecorder::RestartState, state, (uint16_t) countStateBytes);
+	inputRecording.countRecorded = 0;
+	InputRecorder::restart(state, (uint16_t) countStateBytes);
+	SyncAgent::loopFromRestart(state, (uint16_t) countStateBytes);	// Never returns, like loop()
+	return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * Host tool: make a recording without a target, to try replay.
+ *
+ * Runs SyncAgent on the host platform (tools/hostPlatform) with a scripted neighbour:
+ * another master with better ID, xmitting MasterSync in the middle of its sync slot every period,
+ * its sync slot overlapping self's.  Self hears it in self's sync slot, and joins its clique.
+ * Every CorruptEvery'th packet fails CRC.
+ * When the recording has wrapped (half again its size), writes it like the debugger would (see inputRecorder.h.)
+ * Replay of it starts from a restart.  Argument -init: write before it wraps, replay starts from init.
+ *
+ * Build (from this directory):
+ *   g++ -std=c++11 -O2 -DSYNC_AGENT_RECORD_INPUTS=1 -I../hostPlatform -I../../src -o scenario scenario.cpp \
+ *       ../hostPlatform/hostPlatform.cpp $(find ../../src -name '*.cpp' ! -name main.cpp)
+ * Run:
+ *   ./scenario inputs.bin && ./replay inputs.bin
+ *   ./scenario -init inputs.bin && ./replay inputs.bin
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "hostPlatform.h"
+#include "syncAgent/globals.h"
+#include "syncAgent/syncAgent.h"
+#include "syncAgent/scheduleParameters.h"
+#include "syncAgent/modules/inputRecorder.h"
+
+#ifndef SYNC_AGENT_RECORD_INPUTS
+#error "Scenario requires SyncAgent built with SYNC_AGENT_RECORD_INPUTS."
+#endif
+
+
+namespace {
+
+const SystemID SelfID = 0x280;
+const SystemID NeighbourID = 0x100;	// Better than self (least ID is better)
+const LongTime StartTime = 1000000;
+const LongTime NeighbourFirstSyncPoint = StartTime + 7;	// Self's first SyncPoint is StartTime
+const unsigned CorruptEvery = 5;
+
+const char* path;
+uint32_t countToWrite = InputRecording::CountRecords + InputRecording::CountRecords / 2;
+unsigned countPackets = 0;
+LongTime lastXmit = 0;
+
+
+void writeRecording() {
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr) {
+		perror(path);
+		exit(1);
+	}
+	fwrite(&inputRecording, sizeof(inputRecording), 1, file);
+	fclose(file);
+	printf("Wrote %u records since init, %u packets heard\n", inputRecording.countRecorded, countPackets);
+	exit(0);
+}
+
+
+// Neighbour's next xmit not before given time
+LongTime neighbourXmitTime(LongTime notBefore) {
+	LongTime firstXmit = NeighbourFirstSyncPoint + ScheduleParameters::DeltaToSyncSlotMiddle;
+	if (notBefore <= firstXmit)
+		return firstXmit;
+	LongTime periods = (notBefore - firstXmit + ScheduleParameters::NormalSyncPeriodDuration - 1)
+			/ ScheduleParameters::NormalSyncPeriodDuration;
+	return firstXmit + periods * ScheduleParameters::NormalSyncPeriodDuration;
+}
+
+void makeNeighbourFrame() {
+	SyncMessage& msg = serializer.outwardCommonSyncMsg;
+	msg.makeMasterSync(ScheduleParameters::NormalSyncPeriodDuration - ScheduleParameters::DeltaToSyncSlotMiddle,
+			NeighbourID);
+	msg.hopCount = 0;
+	serializer.serializeOutwardCommonSyncMessage();
+}
+
+
+ReasonForWake wakeByNeighbour(LongTime deadline) {
+	if (inputRecording.countRecorded >= countToWrite)
+		writeRecording();
+
+	LongTime now = LongClockTimer::nowTime();
+	if (radio->isEnabledInterruptForMsgReceived()) {
+		// Each xmit heard once
+		LongTime xmit = neighbourXmitTime(now > lastXmit ? now : lastXmit + 1);
+		if (deadline == 0 || xmit < deadline) {
+			lastXmit = xmit;
+			HostPlatform::setNow(xmit);
+			makeNeighbourFrame();
+			countPackets++;
+			HostPlatform::setPacketCRCValid(countPackets % CorruptEvery != 0);
+			return MsgReceived;
+		}
+	}
+	if (now < deadline)
+		HostPlatform::setNow(deadline);
+	return TimerExpired;
+}
+
+
+void onWorkMsg(WorkPayload) {}
+void onSyncPoint() {}
+
+}	// namespace
+
+
+int main(int argc, char** argv) {
+	if (argc == 3 && strcmp(argv[1], "-init") == 0)
+		countToWrite = InputRecording::CountRecords / 2;
+	else if (argc != 2) {
+		fprintf(stderr, "Usage: %s [-init] <recording to write>\n", argv[0]);
+		return 2;
+	}
+	path = argv[argc - 1];
+
+	HostPlatform::setID(SelfID);
+	HostPlatform::setNow(StartTime);
+	Radio hostRadio;
+	Mailbox hostMailbox;
+	LongClockTimer hostLongClockTimer;
+	SyncAgent::init(&hostRadio, &hostMailbox, &hostLongClockTimer, onWorkMsg, onSyncPoint);
+	HostPlatform::setWakeFunc(wakeByNeighbour);
+	SyncAgent::loop();	// Never returns: ends in writeRecording()
+	return 0;
+}
@@ -0,0 +1,103 @@
+#include <cstring>
+
+#include "simulation.h"
+
+
+/*
+ * Platform API (tools/hostPlatform/nRF5x.h) for units of a Simulation.
+ *
+ * State of a unit's devices is in its Unit (simulator reads it while unit is not resident.)
+ * Globals here (radio buffer, retained memory) are per unit: swapped with SyncAgent's.
+ */
+
+namespace {
+
+uint8_t buffer[Radio::FixedPayloadCount];
+
+uint8_t retained[64];
+bool isRetainedWritten = false;
+
+Unit* unit() { return simulation->current(); }
+
+}	// namespace
+
+
+void initLogging() {}
+void log(const char*) {}
+void logInt(uint32_t) {}
+void logLongLong(uint64_t) {}
+
+SystemID myID() { return unit()->id; }
+
+
+void HfCrystalClock::start() {}
+void HfCrystalClock::startAndSleepUntilRunning() {}
+void HfCrystalClock::stop() {}
+bool HfCrystalClock::isRunning() { return true; }
+
+
+void Radio::setMsgReceivedCallback(void (*)()) {}
+void Radio::configureNetworkAddress(uint32_t, uint8_t) {}
+void Radio::powerOnAndConfigure() { unit()->isPowerOn = true; }
+void Radio::configureXmitPower(int8_t dBm) { unit()->xmitPower = dBm; }
+void Radio::configureChannel(uint8_t channel) { unit()->channel = channel; }
+void Radio::powerOff() { unit()->isPowerOn = false; unit()->isReceiving = false; }
+bool Radio::isPowerOn() { return unit()->isPowerOn; }
+bool Radio::isDisabledState() { return !unit()->isReceiving; }
+void Radio::transmitStaticSynchronously() { simulation->transmit(buffer); }
+void Radio::receiveStatic() {
+	unit()->isReceiving = true;
+	unit()->receiveStart = simulation->now();
+}
+bool Radio::isEnabledInterruptForMsgReceived() { return unit()->isReceiving; }
+void Radio::stopReceive() { unit()->isReceiving = false; }
+BufferPointer Radio::getBufferAddress() { return buffer; }
+bool Radio::isPacketCRCValid() { return unit()->isFrameValid; }
+bool Radio::isChannelClear() { return simulation->isChannelClear(); }
+int8_t Radio::receivedSignalStrength() { return unit()->signalStrength; }
+
+
+LongTime LongClockTimer::nowTime() { return simulation->localTime(); }
+void LongClockTimer::reset() {}
+
+
+void Sleeper::init(OSTime, LongClockTimer*) {}
+void Sleeper::sleepUntilEventWithTimeout(OSTime timeout) {
+	setDeadline(LongClockTimer::nowTime() + timeout);
+	sleepUntilEvent();
+}
+void Sleeper::cancelTimeout() { unit()->armedDeadline = 0; }
+void Sleeper::setDeadline(LongTime deadline) { unit()->armedDeadline = deadline; }
+
+void Sleeper::sleepUntilEvent() {
+	simulation->sleep();
+	// Radio buffer is per unit: frame lands in it when unit is resident again
+	if (unit()->reasonForWake == MsgReceived)
+		memcpy(buffer, unit()->frame, sizeof(buffer));
+}
+
+ReasonForWake Sleeper::getReasonForWake() { return unit()->reasonForWake; }
+void Sleeper::clearReasonForWake() { unit()->reasonForWake = None; }
+void Sleeper::msgReceivedCallback() {}
+
+
+void Mailbox::put(WorkPayload) {}
+WorkPayload Mailbox::fetch() { return 0; }
+bool Mailbox::isMail() { return false; }
+
+void LEDLogger::init() {}
+void LEDLogger::toggleLED(int) {}
+
+bool PowerManager::isPowerForRadio() { return true; }
+
+
+uint16_t RetainedMemory::size() { return sizeof(retained); }
+void RetainedMemory::read(uint8_t* data, uint16_t count) { memcpy(data, retained, count); }
+void RetainedMemory::write(const uint8_t* data, uint16_t count) {
+	memcpy(retained, data, count);
+	isRetainedWritten = true;
+}
+bool RetainedMemory::ticksSinceWrite(uint64_t* ticks) {
+	*ticks = 0;
+	return isRetainedWritten;
+}
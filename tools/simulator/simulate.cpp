@@ -0,0 +1,113 @@
+/*
+ * Host tool: simulate a network of SyncAgent units (see simulation.h.)
+ *
+ * Units boot at random phases, each master of its own clique.
+ * Units are placed at random in a square area.  Default: everyone in range of everyone.
+ * An installation spread wider than radio range is a multi-hop network: e.g. 10000 units, 1000 m, range 30 m.
+ * Clocks drift (see tools/clockModel): static skew, temperature over a day (compress a day to see it), phase noise.
+ * Reports, at intervals of simulated time, how many cliques remain (distinct MasterIDs), and the cost of simulating.
+ * Ends with a digest of every unit's observable state: same for a seed in every run (or a bug in the simulator.)
+ *
+ * Build (from this directory):
+ *   g++ -std=c++11 -O2 -I../hostPlatform -I../clockModel -I../../src -o simulate simulate.cpp simulation.cpp \
+ *       simPlatform.cpp spatialGrid.cpp ../clockModel/clockModel.cpp $(find ../../src -name '*.cpp' ! -name main.cpp)
+ * Options of config.h can be defined on the command line, e.g. a sync period of 75 seconds (over the 64 of a narrow offset):
+ *   -DSYNC_AGENT_WIDE_OFFSET=1 -DSYNC_AGENT_DUTY_CYCLE_INVERSE=30000
+ * and run with small skew (drift per period must stay within a slot), e.g. ./simulate 10 20000 1 10 1000 0 1
+ * Run:
+ *   ./simulate [units [sync periods [seed [side meters [range meters [speed meters/second
+ *       [skew ppm [day seconds]]]]]]]]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include "simulation.h"
+#include "syncAgent/scheduleParameters.h"
+
+
+namespace {
+
+uint64_t nowNanoseconds() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t) time.tv_sec * 1000000000u + (uint64_t) time.tv_nsec;
+}
+
+size_t countCliques(const Simulation& sim) {
+	std::vector<SystemID> masterIDs;
+	for (uint32_t unit = 0; unit < sim.countUnits(); unit++)
+		if (sim.unit(unit).countSyncPoints > 0)
+			masterIDs.push_back(sim.unit(unit).masterID);
+	std::sort(masterIDs.begin(), masterIDs.end());
+	return std::unique(masterIDs.begin(), masterIDs.end()) - masterIDs.begin();
+}
+
+}	// namespace
+
+
+int main(int argc, char** argv) {
+	uint32_t countUnits = (argc > 1) ? (uint32_t) atoi(argv[1]) : 100;
+	uint32_t countPeriods = (argc > 2) ? (uint32_t) atoi(argv[2]) : 100;
+	uint64_t seed = (argc > 3) ? strtoull(argv[3], nullptr, 0) : 1;
+	Layout layout;
+	if (argc > 4)
+		layout.width = layout.height = (float) atof(argv[4]);
+	if (argc > 5)
+		layout.range = (float) atof(argv[5]);
+	if (argc > 6)
+		layout.speed = (float) atof(argv[6]);
+	ClockParameters clockParameters;
+	if (argc > 7)
+		clockParameters.staticPPM = (float) atof(argv[7]);
+	if (argc > 8)
+		clockParameters.dayTicks = (float) atof(argv[8]) * 32768;
+	if (countUnits == 0 || countPeriods == 0
+			|| layout.width < 0 || layout.range <= 0 || layout.speed < 0
+			|| clockParameters.staticPPM < 0 || clockParameters.dayTicks <= 0) {
+		fprintf(stderr, "Usage: %s [units [sync periods [seed "
+				"[side meters [range meters [speed meters/second [skew ppm [day seconds]]]]]]]]\n", argv[0]);
+		return 2;
+	}
+
+	Simulation* sim = new Simulation(countUnits, seed, layout, clockParameters);
+	printf("%u units, %u sync periods, seed %llu.  Per unit: globals %zu bytes, stack %zu bytes (virtual)\n",
+			countUnits, countPeriods, (unsigned long long) seed, sim->stateSize(), Simulation::StackSize);
+	printf("Area %.0f m square, range %.0f m, speed %.1f m/s.  Clock skew +-%.0f ppm, day %.0f s\n",
+			layout.width, layout.range, layout.speed, clockParameters.staticPPM, clockParameters.dayTicks / 32768);
+	printf("%8s %8s %12s %10s %8s %14s\n", "period", "cliques", "events", "seconds", "celsius", "ppm min..max");
+
+	sim->start();
+	uint32_t reportInterval = (countPeriods >= 10) ? countPeriods / 10 : 1;
+	uint64_t start = nowNanoseconds();
+	for (uint32_t period = reportInterval; period <= countPeriods; period += reportInterval) {
+		sim->runUntil((LongTime) period * ScheduleParameters::NormalSyncPeriodDuration);
+		const ClockModel& clocks = sim->clockModel();
+		float minPPM = clocks.ppm(0), maxPPM = clocks.ppm(0);
+		for (uint32_t unit = 1; unit < countUnits; unit++) {
+			minPPM = std::min(minPPM, clocks.ppm(unit));
+			maxPPM = std::max(maxPPM, clocks.ppm(unit));
+		}
+		printf("%8u %8zu %12llu %10.2f %8.1f %6.1f..%6.1f\n",
+				period,
+				countCliques(*sim),
+				(unsigned long long) sim->countEvents(),
+				(nowNanoseconds() - start) / 1e9,
+				clocks.celsius(), minPPM, maxPPM);
+	}
+
+	uint64_t transmits = 0, receives = 0, collisions = 0;
+	for (uint32_t unit = 0; unit < sim->countUnits(); unit++) {
+		transmits += sim->unit(unit).countTransmits;
+		receives += sim->unit(unit).countReceives;
+		collisions += sim->unit(unit).countCollisions;
+	}
+	double seconds = (nowNanoseconds() - start) / 1e9;
+	printf("xmits %llu, receives %llu, collisions %llu.  %.0f events/s.  Digest %016llx\n",
+			(unsigned long long) transmits, (unsigned long long) receives, (unsigned long long) collisions,
+			sim->countEvents() / seconds, (unsigned long long) sim->digest());
+	return 0;
+}
@@ -0,0 +1,418 @@
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "simulation.h"
+#include "syncAgent/globals.h"
+#include "syncAgent/syncAgent.h"
+#include "syncAgent/scheduleParameters.h"
+#include "syncAgent/modules/clique.h"
+
+
+Simulation* simulation = nullptr;
+
+const DeltaTime Simulation::MoveInterval = ScheduleParameters::NormalSyncPeriodDuration;
+
+
+// Linker defined bounds of globals (.data then .bss) of the executable
+extern "C" char __data_start[];
+extern "C" char _end[];
+
+
+/*
+ * Frame xmitted by a unit, heard by units in range.
+ */
+struct Broadcast {
+	LongTime time;	// True time of xmit
+	uint32_t sender;
+	uint8_t channel;
+	int8_t xmitPower;	// dBm
+	uint8_t frame[Radio::FixedPayloadCount];
+};
+
+
+namespace {
+
+// Radio timing, true ticks
+const DeltaTime RampupDelay = ScheduleParameters::RampupDelay;
+const DeltaTime Airtime = ScheduleParameters::MsgOverTheAirTimeInTicks;
+const float TicksPerSecond = 32768;
+
+// Log distance path loss: 40 dB at one meter, exponent 2.5 (indoors)
+int8_t signalStrengthAt(int8_t xmitPower, float squaredDistance) {
+	float dBm = xmitPower - 40.0f - 12.5f * log10f((squaredDistance > 1.0f) ? squaredDistance : 1.0f);
+	return (dBm > -127.0f) ? (int8_t) dBm : -127;
+}
+
+
+uint64_t splitMix(uint64_t* state) {
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// In [0, 1)
+float randomUnit(uint64_t* state) { return (float) (splitMix(state) >> 40) / (float) (1 << 24); }
+
+// FNV-1a
+uint64_t hashBytes(uint64_t hash, const void* data, size_t count) {
+	const uint8_t* bytes = (const uint8_t*) data;
+	for (size_t i = 0; i < count; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+// Of an integer's bytes: no padding, no pointers
+template <typename Value>
+uint64_t hashValue(uint64_t hash, Value value) { return hashBytes(hash, &value, sizeof(value)); }
+
+
+// App of every unit
+void onWorkMsg(WorkPayload) {}
+
+void onSyncPoint() {
+	Unit* unit = simulation->current();
+	unit->masterID = clique.getMasterID();
+	unit->countSyncPoints++;
+}
+
+// Entry of a unit's fiber
+void unitMain() {
+	Radio unitRadio;
+	Mailbox unitMailbox;
+	LongClockTimer unitLongClockTimer;
+	SyncAgent::init(&unitRadio, &unitMailbox, &unitLongClockTimer, onWorkMsg, onSyncPoint);
+	SyncAgent::loop();	// Never returns
+	assert(false);
+}
+
+} // namespace
+
+
+
+size_t Simulation::stateSize() const { return (size_t) (_end - __data_start); }
+
+
+Simulation::Simulation(uint32_t countUnits, uint64_t seed, const Layout& aLayout, const ClockParameters& clockParameters) :
+		layout(aLayout),
+		grid(aLayout.width, aLayout.height, aLayout.range, countUnits),
+		nextMove(MoveInterval),
+		clocks(countUnits, seed, clockParameters)
+{
+	// Before snapshot: every snapshot holds it
+	simulation = this;
+
+	// Globals as after static initialization: every unit starts from them, like from reset
+	initialState = (uint8_t*) malloc(stateSize());
+	memcpy(initialState, __data_start, stateSize());
+
+	uint64_t random = seed;
+	_units.reserve(countUnits);
+	for (uint32_t index = 0; index < countUnits; index++) {
+		Unit* unit = new Unit();
+		unit->index = index;
+		// 48 bits like nRF FICR, never zero
+		unit->id = (splitMix(&random) & 0xFFFFFFFFFFFFULL) | 1;
+		// Units boot at random in first sync period: cliques at random phases
+		unit->bootTime = splitMix(&random) % ScheduleParameters::NormalSyncPeriodDuration;
+		clocks.boot(index, unit->bootTime);
+		Position position;
+		position.x = randomUnit(&random) * layout.width;
+		position.y = randomUnit(&random) * layout.height;
+		grid.insert(index, position);
+		float heading = randomUnit(&random) * 2 * (float) M_PI;
+		unit->velocityX = layout.speed * cosf(heading);
+		unit->velocityY = layout.speed * sinf(heading);
+		_units.push_back(unit);
+	}
+}
+
+
+
+void Simulation::start() {
+	for (Unit* unit : _units) {
+		unit->state = (uint8_t*) malloc(stateSize());
+		memcpy(unit->state, initialState, stateSize());
+
+		unit->stack = (uint8_t*) malloc(StackSize);
+		getcontext(&unit->context);
+		unit->context.uc_stack.ss_sp = unit->stack;
+		unit->context.uc_stack.ss_size = StackSize;
+		unit->context.uc_link = &loopContext;
+		makecontext(&unit->context, unitMain, 0);
+
+		schedule(Event::Boot, unit, unit->bootTime, 0);
+	}
+	free(initialState);
+	initialState = nullptr;
+}
+
+
+void Simulation::schedule(Event::Kind kind, Unit* unit, LongTime time, uint32_t tiebreak) {
+	Event event;
+	event.time = time;
+	event.unit = unit->index;
+	event.kind = kind;
+	event.tiebreak = tiebreak;
+	queue.push(event);
+}
+
+
+void Simulation::runUntil(LongTime endTime) {
+	while (!queue.empty() && queue.top().time <= endTime) {
+		LongTime time = queue.top().time;
+		if (layout.speed > 0)
+			while (nextMove <= time) {
+				moveUnits(MoveInterval);
+				nextMove += MoveInterval;
+			}
+		if (time >= clocks.nextStep()) {
+			clocks.advance(time);
+			_now = time;
+			// Timers at the new rates: one may now be first
+			for (Unit* unit : _units)
+				if (unit->isSleeping && !unit->isTransmitting && unit->armedDeadline != 0)
+					scheduleDeadline(unit);
+			continue;
+		}
+
+		Event event = queue.top();
+		queue.pop();
+		_now = event.time;
+		_countEvents++;
+		dispatch(event);
+	}
+	_now = endTime;
+}
+
+
+void Simulation::moveUnits(DeltaTime elapsed) {
+	float seconds = elapsed / TicksPerSecond;
+	for (Unit* unit : _units) {
+		Position position = grid.position(unit->index);
+		position.x += unit->velocityX * seconds;
+		position.y += unit->velocityY * seconds;
+		// Bounce
+		if (position.x < 0 || position.x > layout.width) {
+			unit->velocityX = -unit->velocityX;
+			position.x = (position.x < 0) ? -position.x : 2 * layout.width - position.x;
+		}
+		if (position.y < 0 || position.y > layout.height) {
+			unit->velocityY = -unit->velocityY;
+			position.y = (position.y < 0) ? -position.y : 2 * layout.height - position.y;
+		}
+		grid.move(unit->index, position);
+	}
+}
+
+
+void Simulation::hear(Unit* receiver, const Broadcast& broadcast, float squaredDistance) {
+	Incoming frame;
+	frame.start = broadcast.time + RampupDelay;
+	frame.end = frame.start + Airtime;
+	frame.sender = broadcast.sender;
+	frame.channel = broadcast.channel;
+	frame.isCorrupt = false;
+	frame.signalStrength = signalStrengthAt(broadcast.xmitPower, squaredDistance);
+	memcpy(frame.frame, broadcast.frame, sizeof(frame.frame));
+	receiver->incoming.push_back(frame);
+	schedule(Event::Arrival, receiver, frame.end, broadcast.sender);
+}
+
+
+void Simulation::dispatch(const Event& event) {
+	Unit* unit = _units[event.unit];
+	switch (event.kind) {
+	case Event::Boot:
+		run(unit);
+		break;
+
+	case Event::Timer:
+		// Stale if unit woke (or slept again) since scheduled
+		if (!unit->isSleeping || unit->isTransmitting || unit->sleepGeneration != event.tiebreak)
+			break;
+		// Scheduled at an earlier step's rates: clock may not be there yet
+		if (clocks.localTime(unit->index, _now) < unit->armedDeadline)
+			scheduleDeadline(unit);
+		else
+			wake(unit, TimerExpired);
+		break;
+
+	case Event::Sent:
+		if (unit->isSleeping && unit->sleepGeneration == event.tiebreak)
+			wake(unit, TimerExpired);
+		break;
+
+	case Event::Arrival:
+		arrive(unit, event.tiebreak);
+		break;
+	}
+}
+
+
+/*
+ * End of a frame at a receiver.
+ * Every frame overlapping it is in incoming: it started before this one ended, so was xmitted (and heard) earlier.
+ * Collisions are symmetric, so the order frames were heard in doesn't matter.
+ */
+void Simulation::arrive(Unit* unit, uint32_t sender) {
+	std::vector<Incoming>& incoming = unit->incoming;
+	size_t arrived = 0;
+	while (incoming[arrived].sender != sender || incoming[arrived].end != _now)
+		arrived++;
+
+	for (size_t i = 0; i < incoming.size(); i++) {
+		if (i != arrived
+				&& incoming[i].channel == incoming[arrived].channel
+				&& incoming[i].start < incoming[arrived].end && incoming[arrived].start < incoming[i].end) {
+			incoming[i].isCorrupt = true;
+			incoming[arrived].isCorrupt = true;
+		}
+	}
+	Incoming frame = incoming[arrived];
+	incoming.erase(incoming.begin() + arrived);
+
+	if (frame.isCorrupt)
+		unit->countCollisions++;
+
+	// Receiver must have listened, on the frame's channel, from start of frame
+	if (unit->isReceiving && unit->isSleeping
+			&& unit->channel == frame.channel && unit->receiveStart <= frame.start) {
+		memcpy(unit->frame, frame.frame, sizeof(unit->frame));
+		unit->isFrameValid = !frame.isCorrupt;
+		unit->signalStrength = frame.signalStrength;
+		unit->countReceives++;
+		// Like target: radio DISABLED after receive
+		unit->isReceiving = false;
+		wake(unit, MsgReceived);
+	}
+}
+
+
+void Simulation::wake(Unit* unit, ReasonForWake reason) {
+	unit->reasonForWake = reason;
+	unit->sleepGeneration++;	// Other events for this sleep are stale
+	run(unit);
+}
+
+
+void Simulation::run(Unit* unit) {
+	makeResident(unit);
+	_current = unit;
+	swapcontext(&loopContext, &unit->context);
+	_current = nullptr;
+}
+
+
+void Simulation::suspend() {
+	Unit* unit = _current;
+	swapcontext(&unit->context, &loopContext);
+	// Resumed: resident again, _current is unit
+}
+
+
+void Simulation::makeResident(Unit* unit) {
+	if (resident == unit)
+		return;
+	if (resident != nullptr)
+		memcpy(resident->state, __data_start, stateSize());
+	memcpy(__data_start, unit->state, stateSize());
+	resident = unit;
+}
+
+
+
+void Simulation::sleep() {
+	Unit* unit = _current;
+	unit->isSleeping = true;
+	if (unit->armedDeadline != 0)
+		scheduleDeadline(unit);
+	suspend();
+	unit->isSleeping = false;
+	if (unit->reasonForWake == TimerExpired)
+		unit->armedDeadline = 0;
+}
+
+
+// Timer event at true time unit's clock reaches its deadline, now if past
+void Simulation::scheduleDeadline(Unit* unit) {
+	LongTime deadline = clocks.trueTime(unit->index, unit->armedDeadline);
+	schedule(Event::Timer, unit, (deadline > _now) ? deadline : _now, unit->sleepGeneration);
+}
+
+
+/*
+ * Synchronous: sender blocks while frame is on air.
+ *
+ * Units in range hear it now, before it is on air.
+ * A receiver whose radio is off now doesn't hear the frame, even if it powers on while frame is on air:
+ * it misses that frame's collisions and clear channel.
+ * Most units' radios are off most of the time: most of the cost of a broadcast is in the grid lookup.
+ */
+void Simulation::transmit(const volatile uint8_t* frame) {
+	Unit* sender = _current;
+	sender->countTransmits++;
+
+	Broadcast broadcast;
+	broadcast.time = _now;
+	broadcast.sender = sender->index;
+	broadcast.channel = sender->channel;
+	broadcast.xmitPower = sender->xmitPower;
+	for (uint8_t i = 0; i < Radio::FixedPayloadCount; i++)
+		broadcast.frame[i] = frame[i];
+	grid.forEachInRange(sender->index, [&](uint32_t receiver, float squaredDistance) {
+		if (_units[receiver]->isPowerOn)
+			hear(_units[receiver], broadcast, squaredDistance);
+	});
+
+	// Sender resumes when frame is sent, like a timer.  Not a wake seen by SyncAgent.
+	ReasonForWake reasonForWake = sender->reasonForWake;
+	sender->isSleeping = true;
+	sender->isTransmitting = true;
+	schedule(Event::Sent, sender, _now + RampupDelay + Airtime, sender->sleepGeneration);
+	suspend();
+	sender->isSleeping = false;
+	sender->isTransmitting = false;
+	sender->reasonForWake = reasonForWake;
+}
+
+
+bool Simulation::isChannelClear() const {
+	for (const Incoming& frame : _current->incoming)
+		if (frame.channel == _current->channel && frame.start <= _now && _now < frame.end)
+			return false;
+	return true;
+}
+
+
+
+uint64_t Simulation::digest() {
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for (Unit* unit : _units) {
+		// SyncAgent's getters read the unit's globals
+		makeResident(unit);
+		hash = hashValue(hash, clique.getMasterID());
+		hash = hashValue(hash, clique.channel());
+		hash = hashValue(hash, clique.schedule.startTimeOfSyncPeriod());
+		hash = hashValue(hash, clique.schedule.timeOfNextSyncPoint());
+		hash = hashValue(hash, clique.schedule.driftPerPeriod());
+		hash = hashValue(hash, clique.schedule.countLateSyncPoints());
+		hash = hashValue(hash, clique.schedule.countSkippedPeriods());
+		hash = hashValue(hash, unit->countSyncPoints);
+		hash = hashValue(hash, unit->countTransmits);
+		hash = hashValue(hash, unit->countReceives);
+		hash = hashValue(hash, unit->countCollisions);
+
+		// Checkpoint as saved (zero padded, see SyncCheckpoint), zero if never saved
+		uint8_t retained[64];
+		uint16_t size = RetainedMemory::size();
+		assert(size <= sizeof(retained));
+		RetainedMemory::read(retained, size);
+		hash = hashBytes(hash, retained, size);
+	}
+	return hash;
+}
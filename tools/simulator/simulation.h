@@ -0,0 +1,211 @@
+#pragma once
+
+#include <inttypes.h>
+#include <queue>
+#include <vector>
+#include <ucontext.h>
+
+#include <nRF5x.h>	// tools/hostPlatform: platform API, types
+#include "syncAgent/types.h"	// DeltaTime
+
+#include "spatialGrid.h"
+#include "clockModel.h"	// tools/clockModel
+
+
+/*
+ * Simulation of many SyncAgent units in one process, one thread.
+ *
+ * SyncAgent is singletons: its state is globals.  And it blocks: it sleeps inside Sleeper::sleepUntilEvent.
+ * So each unit is:
+ * - a fiber (own stack, ucontext) that runs SyncAgent::init and loop, unmodified.
+ *   Platform's blocking points (sleep, synchronous transmit) switch back to the event loop.
+ * - a snapshot of the program's globals (.data and .bss), swapped in while the unit runs.
+ *
+ * Event loop pops events in order of true time, runs the unit to its next blocking point.
+ * Time stands still while a unit runs: SyncAgent's code takes zero time.
+ * Memory is a snapshot and the touched part of a stack per unit, time is per event (two copies of a snapshot.)
+ *
+ * Not parallel, by decision.  A conservative parallel simulation (units partitioned across workers,
+ * advancing in windows of lookahead, frames exchanged at window ends) was built and measured, and removed:
+ * - lookahead is at most airtime plus RadioLag, 4 ticks (RampupDelay, 2, since clear channel sees a frame from its start)
+ * - a window holds 2.4 events across 300 units, 3.8 across 3000 multi-hop: under one per worker of four
+ * - so a barrier per event or two: 4 workers ran 110k events/s, 1 worker 441k, this serial loop 1.7M
+ * More units don't fill windows much (sync slots are spread over the period), so no unit count pays for workers.
+ * For Monte Carlo, run independent seeds in separate processes instead: same digests, linear speedup.
+ *
+ * Deterministic for a seed.
+ * Events are ordered by (time, unit, kind, tiebreak), never by when they were scheduled,
+ * and the medium decides collisions and clear channel from frames alone, in any order of delivery.
+ * digest() hashes what is observable of every unit, without pointers: same for a seed in any run.
+ *
+ * !!! Simulator's own state is on the heap, reached through the pointer simulation (same in every snapshot.)
+ * A global of the simulator that changed after units start would be swapped with units.
+ * Linux, glibc, GNU ld (__data_start, _end), dynamically linked.
+ *
+ * Radio medium: units on a plane (see Layout), a unit hears units within range on the same channel.
+ * Who is in range is looked up in a SpatialGrid: a broadcast touches only units near its sender.
+ * Frames overlapping at a receiver on the same channel collide: all fail CRC.
+ * Collisions are decided per receiver, from the frames it hears: hidden terminals collide at a receiver between them.
+ * A unit hears frames only while its radio is on (powered when the frame is xmitted, see transmit.)
+ * A receiver receives a frame if it was listening, on the frame's channel, from start of frame to end.
+ * Signal strength falls with distance (log distance path loss.)
+ * Mobile units move in straight lines, bouncing off the edges of the area, at intervals of MoveInterval.
+ *
+ * Clocks: a ClockModel of every unit's crystal (skew, temperature, phase noise), its LongClock zero at boot.
+ * All clocks advance at the same steps, at the first event at or after a step.
+ * A timer is scheduled at the true time the unit's clock reaches its deadline, at the rates of the current step.
+ * At each step, timers of sleeping units are scheduled again at the new rates, and a timer checks its deadline when it fires.
+ */
+
+
+// Frame on air, as heard by a receiver
+struct Incoming {
+	LongTime start;	// True time
+	LongTime end;
+	uint32_t sender;
+	uint8_t channel;
+	bool isCorrupt;
+	int8_t signalStrength;	// dBm
+	uint8_t frame[Radio::FixedPayloadCount];
+};
+
+
+// Placement of units, and radio
+struct Layout {
+	float width = 10;	// Meters.  Units are placed uniformly at random in the area.
+	float height = 10;
+	float range = 30;	// Meters.  Default: everyone hears everyone.
+	float speed = 0;	// Meters per second, of every unit, each in a random direction.  Zero is fixed units.
+};
+
+
+struct Unit {
+	uint32_t index;
+	SystemID id;
+	LongTime bootTime;	// True time at which unit starts, its LongClock zero (see ClockModel)
+	float velocityX;	// Meters per second.  Position is in Simulation's grid.
+	float velocityY;
+
+	// Fiber
+	ucontext_t context;
+	uint8_t* stack;
+	uint8_t* state;	// Snapshot of globals while not resident
+
+	// Sleeper
+	uint32_t sleepGeneration;	// Events for earlier sleeps are stale
+	bool isSleeping;
+	bool isTransmitting;	// Sleeping until end of own xmit (Sent), not a sleep of SyncAgent
+	LongTime armedDeadline;	// Local time, zero is none
+	ReasonForWake reasonForWake;
+
+	// Radio
+	bool isPowerOn;
+	bool isReceiving;
+	uint8_t channel;
+	int8_t xmitPower;	// dBm, platform's default zero
+	LongTime receiveStart;	// True time
+	std::vector<Incoming> incoming;	// On air, or arrived (collision not yet decided for all overlapping)
+	uint8_t frame[Radio::FixedPayloadCount];	// Arrived, in radio buffer when unit wakes
+	bool isFrameValid;
+	int8_t signalStrength;
+
+	// Observed
+	SystemID masterID;	// At last SyncPoint
+	uint32_t countSyncPoints;
+	uint32_t countTransmits;
+	uint32_t countReceives;
+	uint32_t countCollisions;
+};
+
+
+struct Event {
+	// Order of kinds at the same time, for the same unit
+	enum Kind : uint8_t { Boot, Arrival, Timer, Sent };
+
+	LongTime time;	// True
+	uint32_t unit;
+	Kind kind;
+	uint32_t tiebreak;	// Timer, Sent: sleepGeneration when scheduled.  Arrival: sender.
+};
+
+struct LaterEvent {
+	bool operator()(const Event& a, const Event& b) const {
+		if (a.time != b.time) return a.time > b.time;
+		if (a.unit != b.unit) return a.unit > b.unit;
+		if (a.kind != b.kind) return a.kind > b.kind;
+		return a.tiebreak > b.tiebreak;
+	}
+};
+
+
+struct Broadcast;
+
+
+class Simulation {
+public:
+	static const size_t StackSize = 64 * 1024;
+
+	// Mobile units move in steps, at the first event at or after
+	static const DeltaTime MoveInterval;
+
+	Simulation(uint32_t countUnits, uint64_t seed, const Layout& layout, const ClockParameters& clockParameters);
+
+	void start();
+
+	// Run events until true time
+	void runUntil(LongTime endTime);
+
+	/*
+	 * Hash of every unit's observable state: master, schedule, counts, retained checkpoint.
+	 * Not of globals whole: they hold pointers (radio, stack), which differ between runs (address randomization.)
+	 */
+	uint64_t digest();
+
+	LongTime now() const { return _now; }
+	uint64_t countEvents() const { return _countEvents; }
+	size_t stateSize() const;
+	uint32_t countUnits() const { return (uint32_t) _units.size(); }
+	const Unit& unit(uint32_t index) const { return *_units[index]; }
+	Unit* current() { return _current; }
+	const ClockModel& clockModel() const { return clocks; }
+
+	// Current unit's LongClock
+	LongTime localTime() const { return clocks.localTime(_current->index, _now); }
+
+	// Blocking points, called by platform in the current unit's fiber
+	void sleep();
+	void transmit(const volatile uint8_t* frame);
+
+	bool isChannelClear() const;
+
+private:
+	std::vector<Unit*> _units;
+	std::priority_queue<Event, std::vector<Event>, LaterEvent> queue;
+	uint64_t _countEvents = 0;
+	LongTime _now = 0;
+
+	uint8_t* initialState = nullptr;
+
+	Layout layout;
+	SpatialGrid grid;
+	LongTime nextMove;
+	ClockModel clocks;
+
+	ucontext_t loopContext;
+	Unit* _current = nullptr;	// Running
+	Unit* resident = nullptr;	// Whose globals are in place
+
+	void schedule(Event::Kind kind, Unit* unit, LongTime time, uint32_t tiebreak);
+	void dispatch(const Event& event);
+	void arrive(Unit* unit, uint32_t sender);
+	void wake(Unit* unit, ReasonForWake reason);
+	void run(Unit* unit);
+	void suspend();
+	void makeResident(Unit* unit);
+	void moveUnits(DeltaTime elapsed);
+	void scheduleDeadline(Unit* unit);
+	void hear(Unit* receiver, const Broadcast& broadcast, float squaredDistance);
+};
+
+// Set once by Simulation's constructor, see above
+extern Simulation* simulation;
@@ -0,0 +1,56 @@
+#include <cassert>
+
+#include "spatialGrid.h"
+
+
+SpatialGrid::SpatialGrid(float width, float height, float range, uint32_t countUnits) :
+		cellSide(range),
+		countColumns((int32_t) (width / range) + 1),
+		countRows((int32_t) (height / range) + 1),
+		cells(countColumns * countRows),
+		positions(countUnits),
+		cellOfUnit(countUnits),
+		slotOfUnit(countUnits)
+{
+	assert(range > 0);
+}
+
+
+// Clamped: positions outside the area are in its edge cells
+int32_t SpatialGrid::columnOf(float x) const {
+	int32_t column = (x > 0) ? (int32_t) (x / cellSide) : 0;
+	return (column < countColumns) ? column : countColumns - 1;
+}
+
+int32_t SpatialGrid::rowOf(float y) const {
+	int32_t row = (y > 0) ? (int32_t) (y / cellSide) : 0;
+	return (row < countRows) ? row : countRows - 1;
+}
+
+
+void SpatialGrid::insert(uint32_t unit, Position position) {
+	positions[unit] = position;
+	uint32_t cell = cellOf(position);
+	cellOfUnit[unit] = cell;
+	slotOfUnit[unit] = (uint32_t) cells[cell].size();
+	cells[cell].push_back(unit);
+}
+
+
+void SpatialGrid::move(uint32_t unit, Position position) {
+	positions[unit] = position;
+	uint32_t cell = cellOf(position);
+	if (cell == cellOfUnit[unit])
+		return;
+
+	// Swap-remove from old cell
+	std::vector<uint32_t>& old = cells[cellOfUnit[unit]];
+	uint32_t last = old.back();
+	old[slotOfUnit[unit]] = last;
+	slotOfUnit[last] = slotOfUnit[unit];
+	old.pop_back();
+
+	cellOfUnit[unit] = cell;
+	slotOfUnit[unit] = (uint32_t) cells[cell].size();
+	cells[cell].push_back(unit);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <inttypes.h>
+#include <vector>
+
+
+struct Position {
+	float x;	// Meters
+	float y;
+};
+
+
+/*
+ * Uniform grid of units by position, for the radio medium's "who hears whom".
+ *
+ * Cell side is radio range: every unit within range of a point is in the point's cell or one of its eight neighbours.
+ * So a lookup touches units of nine cells, not all units.
+ *
+ * Mobile units: move() re-buckets a unit only when it crosses into another cell (swap-remove, constant time.)
+ * Order of units in a cell depends on history of moves, so callers must not depend on order of forEachInRange.
+ */
+class SpatialGrid {
+public:
+	SpatialGrid(float width, float height, float range, uint32_t countUnits);
+
+	void insert(uint32_t unit, Position position);
+	void move(uint32_t unit, Position position);
+	Position position(uint32_t unit) const { return positions[unit]; }
+	float range() const { return cellSide; }
+
+	// Calls visit(other, squared distance) for every other unit within range of unit
+	template <typename Visitor>
+	void forEachInRange(uint32_t unit, Visitor visit) const {
+		Position center = positions[unit];
+		int32_t column = columnOf(center.x);
+		int32_t row = rowOf(center.y);
+		for (int32_t r = row - 1; r <= row + 1; r++) {
+			if (r < 0 || r >= countRows)
+				continue;
+			for (int32_t c = column - 1; c <= column + 1; c++) {
+				if (c < 0 || c >= countColumns)
+					continue;
+				for (uint32_t other : cells[r * countColumns + c]) {
+					if (other == unit)
+						continue;
+					float dx = positions[other].x - center.x;
+					float dy = positions[other].y - center.y;
+					float squared = dx * dx + dy * dy;
+					if (squared <= cellSide * cellSide)
+						visit(other, squared);
+				}
+			}
+		}
+	}
+
+private:
+	float cellSide;
+	int32_t countColumns;
+	int32_t countRows;
+	std::vector<std::vector<uint32_t>> cells;
+	std::vector<Position> positions;
+	std::vector<uint32_t> cellOfUnit;
+	std::vector<uint32_t> slotOfUnit;	// Index in its cell
+
+	int32_t columnOf(float x) const;
+	int32_t rowOf(float y) const;
+	uint32_t cellOf(Position position) const { return rowOf(position.y) * countColumns + columnOf(position.x); }
+};
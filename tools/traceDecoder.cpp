@@ -0,0 +1,56 @@
+
+/*
+ * Host tool: decode binary trace of SyncAgent (see src/syncAgent/modules/trace.h.)
+ *
+ * Usage:
+ * - on target, debugger dumps memory: gdb "dump binary value trace.bin traceBuffer"
+ * - on host: traceDecoder trace.bin
+ *
+ * Prints records oldest first: time (ticks), delta from previous record, event, arg.
+ * Assumes host is little-endian like target (nRF5x.)
+ *
+ * Build: g++ -std=c++11 -I../src/syncAgent -o traceDecoder traceDecoder.cpp
+ */
+
+#include <cstdio>
+
+#include "logMessage.h"
+
+
+int main(int argc, char** argv) {
+	if (argc != 2) {
+		fprintf(stderr, "Usage: %s <trace dump>\n", argv[0]);
+		return 2;
+	}
+
+	FILE* file = fopen(argv[1], "rb");
+	if (file == nullptr) {
+		perror(argv[1]);
+		return 1;
+	}
+	TraceBuffer buffer;
+	size_t countRead = fread(&buffer, sizeof(buffer), 1, file);
+	fclose(file);
+	if (countRead != 1 || buffer.magic != TraceBuffer::Magic) {
+		fprintf(stderr, "Not a trace dump (or build with different layout.)\n");
+		return 1;
+	}
+
+	// Ring: if wrapped, oldest is at next write position
+	uint32_t count = buffer.countRecorded < TraceBuffer::CountRecords ? buffer.countRecorded : TraceBuffer::CountRecords;
+	uint32_t first = buffer.countRecorded - count;
+	printf("%u records, %u lost to wrap\n", count, first);
+
+	uint32_t previousTime = 0;
+	for (uint32_t i = first; i < buffer.countRecorded; i++) {
+		const TraceRecord& record = buffer.records[i & (TraceBuffer::CountRecords - 1)];
+		uint32_t delta = (i == first) ? 0 : record.time - previousTime;
+		previousTime = record.time;
+		printf("%10u %8u  %-32s %u\n",
+				record.time,
+				delta,
+				LogMessage::nameOf(record.event),
+				record.arg);
+	}
+	return 0;
+}